@@ -0,0 +1,215 @@
+// result_sink.h
+// Buffered result rows for the benchmark binaries, written by a
+// background thread so formatting and I/O stay off the timed loops.
+//
+//   ResultSink out("results.csv", {"Size", "Run_ID", "Time"});
+//   out.row() << n << k << ms;          // queued when the Row goes away
+//   out.close();                        // or let the destructor do it
+//
+// The path picks the format:
+//   "-"         CSV on stdout
+//   "*.col"     typed column file (below)
+//   otherwise   CSV, values formatted exactly as operator<< would, with
+//               'precision' significant digits for doubles (default 6)
+//
+// Column file, little-endian, read by common/result_sink.py:
+//   "RSCOL1\0\0", u32 ncols, then per column u8 type (0 int64,
+//   1 float64, 2 string), u32 name length, name bytes
+//   row groups until EOF: u32 nrows, then per column nrows int64 or
+//   float64 values, or nrows u32 lengths followed by the string bytes
+// A column takes the type of its first value; later numbers are
+// converted to it.
+//
+// Rows reach the file in batches: whenever enough are queued, at least
+// every half second, and on close().
+
+#ifndef RESULT_SINK_H
+#define RESULT_SINK_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+class ResultSink {
+public:
+    using Value = std::variant<long long, double, std::string>;
+
+    // Collects one row; it is queued when the Row is destroyed
+    class Row {
+    public:
+        explicit Row(ResultSink *sink) : sink_(sink) { values_.reserve(sink->columns_.size()); }
+        Row(Row &&o) noexcept : sink_(std::exchange(o.sink_, nullptr)), values_(std::move(o.values_)) {}
+        Row(const Row&) = delete;
+        Row& operator=(const Row&) = delete;
+        ~Row(){ if(sink_) sink_->commit(std::move(values_)); }
+
+        template<class T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+        Row& operator<<(T v){ values_.emplace_back((long long)v); return *this; }
+        template<class T, std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
+        Row& operator<<(T v){ values_.emplace_back((double)v); return *this; }
+        Row& operator<<(const char *s){ values_.emplace_back(std::string(s)); return *this; }
+        Row& operator<<(std::string s){ values_.emplace_back(std::move(s)); return *this; }
+
+    private:
+        ResultSink *sink_;
+        std::vector<Value> values_;
+    };
+
+    ResultSink(const std::string &path, std::vector<std::string> columns, int precision = 6)
+        : columns_(std::move(columns)), precision_(precision) {
+        binary_ = path.size() > 4 && path.compare(path.size() - 4, 4, ".col") == 0;
+        if(path == "-"){
+            out_ = &std::cout;
+        } else {
+            file_.open(path, binary_ ? std::ios::binary : std::ios::out);
+            out_ = &file_;
+        }
+        if(!binary_ && *out_){
+            for(size_t c=0;c<columns_.size();c++) *out_ << (c ? "," : "") << columns_[c];
+            *out_ << "\n" << std::flush;
+        }
+        writer_ = std::thread([this]{ writer_loop(); });
+    }
+
+    ~ResultSink(){ close(); }
+
+    ResultSink(const ResultSink&) = delete;
+    ResultSink& operator=(const ResultSink&) = delete;
+
+    bool ok() const { return (bool)*out_; }
+
+    Row row(){ return Row(this); }
+
+    // Writes everything queued and stops the writer thread
+    void close(){
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            if(closing_) return;
+            closing_ = true;
+        }
+        cv_.notify_one();
+        writer_.join();
+        if(binary_ && !header_written_) write_header({});
+        out_->flush();
+        if(file_.is_open()) file_.close();
+    }
+
+private:
+    static constexpr size_t BATCH = 1024;
+
+    std::vector<std::string> columns_;
+    int precision_;
+    bool binary_ = false;
+    std::ofstream file_;
+    std::ostream *out_ = nullptr;
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::vector<std::vector<Value>> pending_;
+    bool closing_ = false;
+    std::thread writer_;
+
+    // Writer thread only
+    std::vector<unsigned char> types_;
+    bool header_written_ = false;
+
+    void commit(std::vector<Value> &&values){
+        if(values.size() != columns_.size()){
+            std::cerr << "result_sink: row has " << values.size() << " values for "
+                      << columns_.size() << " columns, dropped\n";
+            return;
+        }
+        bool wake;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            pending_.push_back(std::move(values));
+            wake = pending_.size() >= BATCH;
+        }
+        if(wake) cv_.notify_one();
+    }
+
+    void writer_loop(){
+        std::vector<std::vector<Value>> batch;
+        for(;;){
+            bool done;
+            {
+                std::unique_lock<std::mutex> lock(mu_);
+                cv_.wait_for(lock, std::chrono::milliseconds(500),
+                             [&]{ return closing_ || pending_.size() >= BATCH; });
+                batch.swap(pending_);
+                done = closing_;
+            }
+            if(!batch.empty()){
+                if(binary_) write_columns(batch);
+                else write_csv(batch);
+                out_->flush();
+                batch.clear();
+            }
+            if(done) return;
+        }
+    }
+
+    void write_csv(const std::vector<std::vector<Value>> &rows){
+        std::ostream &o = *out_;
+        o.precision(precision_);
+        for(const auto &r : rows){
+            for(size_t c=0;c<r.size();c++){
+                if(c) o << ",";
+                std::visit([&](const auto &v){ o << v; }, r[c]);
+            }
+            o << "\n";
+        }
+    }
+
+    template<class T>
+    void put(const T &v){ out_->write(reinterpret_cast<const char*>(&v), sizeof v); }
+
+    void write_header(const std::vector<Value> &first){
+        out_->write("RSCOL1\0\0", 8);
+        put((uint32_t)columns_.size());
+        types_.assign(columns_.size(), 1);
+        for(size_t c=0;c<columns_.size();c++){
+            if(c < first.size()) types_[c] = (unsigned char)first[c].index();
+            put(types_[c]);
+            put((uint32_t)columns_[c].size());
+            out_->write(columns_[c].data(), columns_[c].size());
+        }
+        header_written_ = true;
+    }
+
+    void write_columns(const std::vector<std::vector<Value>> &rows){
+        if(!header_written_) write_header(rows[0]);
+        put((uint32_t)rows.size());
+        for(size_t c=0;c<columns_.size();c++){
+            if(types_[c] == 2){
+                std::string bytes;
+                for(const auto &r : rows){
+                    const std::string *s = std::get_if<std::string>(&r[c]);
+                    put((uint32_t)(s ? s->size() : 0));
+                    if(s) bytes += *s;
+                }
+                out_->write(bytes.data(), bytes.size());
+                continue;
+            }
+            for(const auto &r : rows){
+                double d = 0;
+                long long i = 0;
+                if(auto p = std::get_if<long long>(&r[c])){ i = *p; d = (double)*p; }
+                else if(auto q = std::get_if<double>(&r[c])){ d = *q; i = (long long)*q; }
+                if(types_[c] == 0) put((int64_t)i);
+                else put(d);
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,58 @@
+"""Reader for the result files written by common/result_sink.h.
+
+read_results(path) returns a pandas DataFrame for either format: CSV, or
+the typed column file (*.col) described in result_sink.h.
+"""
+import struct
+
+import numpy as np
+import pandas as pd
+
+MAGIC = b"RSCOL1\0\0"
+DTYPES = {0: "<i8", 1: "<f8"}
+
+
+def read_columns(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:8] != MAGIC:
+        raise ValueError(f"{path}: not a result column file")
+
+    pos = 8
+    (ncols,) = struct.unpack_from("<I", data, pos)
+    pos += 4
+    names, types = [], []
+    for _ in range(ncols):
+        t, length = struct.unpack_from("<BI", data, pos)
+        pos += 5
+        names.append(data[pos:pos + length].decode())
+        types.append(t)
+        pos += length
+
+    parts = [[] for _ in range(ncols)]
+    while pos < len(data):
+        (nrows,) = struct.unpack_from("<I", data, pos)
+        pos += 4
+        for c, t in enumerate(types):
+            if t in DTYPES:
+                parts[c].append(np.frombuffer(data, DTYPES[t], nrows, pos))
+                pos += 8 * nrows
+            else:
+                lengths = np.frombuffer(data, "<u4", nrows, pos)
+                pos += 4 * nrows
+                strings = []
+                for n in lengths:
+                    strings.append(data[pos:pos + n].decode())
+                    pos += int(n)
+                parts[c].append(np.array(strings, dtype=object))
+
+    return pd.DataFrame({
+        name: np.concatenate(p) if p else np.array([], DTYPES.get(t, object))
+        for name, t, p in zip(names, types, parts)
+    })
+
+
+def read_results(path):
+    if str(path).endswith(".col"):
+        return read_columns(path)
+    return pd.read_csv(path)
@@ -0,0 +1,396 @@
+// csr_graph.h
+// Compressed sparse row graph shared by the min-cut engines.
+//
+// CsrGraph keeps both directions of every undirected edge: row u is
+// adj[off[u] .. off[u+1]) with matching weights in w. Parallel edges are
+// folded into one weighted entry and self-loops are dropped at build time,
+// so memory is O(n + m) and a vertex's neighbourhood is one contiguous run.
+//
+// EdgeArrays is the contraction-friendly form: the u < v half of the rows
+// as flat src/dst/w arrays, so a random edge is a single index and the
+// contracted graph is rebuilt in one sequential pass.
+
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include "mincut_stats.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+struct CsrGraph {
+    int n = 0;
+    std::vector<uint64_t> off;      // n + 1 row offsets
+    std::vector<uint32_t> adj, w;   // neighbour and weight per entry
+
+    size_t edges() const { return adj.size() / 2; }
+};
+
+// Sorts each row of g and folds its parallel entries; rows only ever
+// shrink, so the compaction runs in place
+inline void fold_csr_rows(CsrGraph &g){
+    int n = g.n;
+    std::vector<std::pair<uint32_t,uint32_t>> row;
+    uint64_t out = 0, begin = 0;
+    for(int u=0;u<n;u++){
+        uint64_t end = g.off[u + 1];
+        row.clear();
+        for(uint64_t i=begin;i<end;i++) row.emplace_back(g.adj[i], g.w[i]);
+        std::sort(row.begin(), row.end());
+
+        g.off[u] = out;
+        for(const auto &[v, wt] : row){
+            if(out > g.off[u] && g.adj[out - 1] == v){
+                g.w[out - 1] += wt;
+            } else {
+                g.adj[out] = v;
+                g.w[out] = wt;
+                out++;
+            }
+        }
+        begin = end;
+    }
+    g.off[n] = out;
+    g.adj.resize(out);
+    g.w.resize(out);
+    g.adj.shrink_to_fit();
+    g.w.shrink_to_fit();
+}
+
+// Builds from m edges; edge(i, u, v, w) fills in the i-th edge
+template<class EdgeFn>
+CsrGraph build_csr(int n, size_t m, EdgeFn edge){
+    MINCUT_PHASE(MP_COPY);
+    CsrGraph g;
+    g.n = n;
+    g.off.assign(n + 1, 0);
+
+    for(size_t i=0;i<m;i++){
+        int u, v, wt;
+        edge(i, u, v, wt);
+        if(u == v) continue;
+        g.off[u + 1]++;
+        g.off[v + 1]++;
+    }
+    for(int u=0;u<n;u++) g.off[u + 1] += g.off[u];
+
+    g.adj.resize(g.off[n]);
+    g.w.resize(g.off[n]);
+    std::vector<uint64_t> pos(g.off.begin(), g.off.end() - 1);
+    for(size_t i=0;i<m;i++){
+        int u, v, wt;
+        edge(i, u, v, wt);
+        if(u == v) continue;
+        uint64_t a = pos[u]++, b = pos[v]++;
+        g.adj[a] = v; g.w[a] = wt;
+        g.adj[b] = u; g.w[b] = wt;
+    }
+
+    fold_csr_rows(g);
+    return g;
+}
+
+// Unweighted edge list (parallel edges become weights)
+inline CsrGraph build_csr(int n, const std::vector<std::pair<int,int>>& edges){
+    return build_csr(n, edges.size(), [&](size_t i, int &u, int &v, int &wt){
+        u = edges[i].first; v = edges[i].second; wt = 1;
+    });
+}
+
+// ------------------------------------------------------------
+// Contraction-friendly edge arrays (each edge once, u < v)
+// ------------------------------------------------------------
+struct EdgeArrays {
+    int n = 0;
+    std::vector<uint32_t> src, dst, w;
+};
+
+inline EdgeArrays upper_edges(const CsrGraph& g){
+    MINCUT_PHASE(MP_COPY);
+    EdgeArrays ea;
+    ea.n = g.n;
+    ea.src.reserve(g.edges());
+    ea.dst.reserve(g.edges());
+    ea.w.reserve(g.edges());
+    for(int u=0;u<g.n;u++)
+        for(uint64_t i=g.off[u];i<g.off[u + 1];i++)
+            if(g.adj[i] > (uint32_t)u){
+                ea.src.push_back(u);
+                ea.dst.push_back(g.adj[i]);
+                ea.w.push_back(g.w[i]);
+            }
+    return ea;
+}
+
+// Union–find over vertex ids (union by size, path halving)
+struct CsrUnionFind {
+    std::vector<int> p, sz;
+    int comp = 0;
+
+    explicit CsrUnionFind(int n) : p(n), sz(n, 1), comp(n) {
+        std::iota(p.begin(), p.end(), 0);
+    }
+    int find(int x){
+        MINCUT_COUNT(dsu_finds, 1);
+        while(p[x] != x){ p[x] = p[p[x]]; x = p[x]; MINCUT_COUNT(dsu_finds, 1); }
+        return x;
+    }
+    bool unite(int a, int b){
+        a = find(a); b = find(b);
+        if(a == b) return false;
+        if(sz[a] < sz[b]) std::swap(a, b);
+        p[b] = a;
+        sz[a] += sz[b];
+        comp--;
+        return true;
+    }
+};
+
+// ------------------------------------------------------------
+// Weight-proportional contraction down to 'target' super-vertices.
+// An edge is drawn by binary search over prefix sums of the live
+// weights; a draw that lands on a self-loop is rejected. Once rejections
+// reach half the live set, self-loops are filtered out and the prefix
+// sums rebuilt, so each edge is rescanned O(1) times amortized.
+// Stops early if the graph runs out of edges of nonzero weight (it is
+// disconnected).
+// ------------------------------------------------------------
+inline void contract_csr(const EdgeArrays& ea, int target, std::mt19937 &rng, CsrUnionFind &uf){
+    MINCUT_PHASE(MP_CONTRACT);
+    size_t m = ea.src.size();
+    std::vector<uint32_t> live(m);
+    std::iota(live.begin(), live.end(), 0);
+    std::vector<uint64_t> prefix;
+    prefix.reserve(m);
+
+    auto rebuild = [&]{
+        MINCUT_PHASE(MP_REBUILD);
+        size_t out = 0;
+        prefix.clear();
+        uint64_t sum = 0;
+        for(uint32_t i : live){
+            if(uf.find(ea.src[i]) == uf.find(ea.dst[i])) continue;
+            live[out++] = i;
+            sum += ea.w[i];
+            prefix.push_back(sum);
+        }
+        MINCUT_COUNT(self_loops, live.size() - out);
+        live.resize(out);
+    };
+    rebuild();
+
+    size_t rejects = 0;
+    while(uf.comp > target && !live.empty() && prefix.back() > 0){
+        std::uniform_int_distribution<uint64_t> dist(0, prefix.back() - 1);
+        uint64_t x = dist(rng);
+        size_t k = std::upper_bound(prefix.begin(), prefix.end(), x) - prefix.begin();
+        uint32_t i = live[k];
+
+        if(uf.unite(ea.src[i], ea.dst[i])){
+            MINCUT_COUNT(contractions, 1);
+        } else {
+            MINCUT_COUNT(self_loops, 1);
+            if(++rejects > live.size() / 2){
+                rebuild();
+                rejects = 0;
+            }
+        }
+    }
+}
+
+// One Karger run: contract to two super-vertices, return the crossing weight.
+// Repeated runs can share one EdgeArrays.
+inline long long karger_once_csr(const EdgeArrays& ea, std::mt19937 &rng){
+    CsrUnionFind uf(ea.n);
+    contract_csr(ea, 2, rng, uf);
+
+    long long cut = 0;
+    for(size_t i=0;i<ea.src.size();i++)
+        if(uf.find(ea.src[i]) != uf.find(ea.dst[i])) cut += ea.w[i];
+    return cut;
+}
+
+inline long long karger_once_csr(const CsrGraph& g, std::mt19937 &rng){
+    return karger_once_csr(upper_edges(g), rng);
+}
+
+// Graph with every union–find class merged into one vertex (classes are
+// numbered in order of their smallest member; parallel entries folded)
+inline CsrGraph quotient_csr(const EdgeArrays& ea, CsrUnionFind &uf){
+    MINCUT_PHASE(MP_RELABEL);
+    std::vector<int> label(ea.n, -1);
+    int id = 0;
+    for(int v=0;v<ea.n;v++){
+        int r = uf.find(v);
+        if(label[r] < 0) label[r] = id++;
+    }
+    for(int v=0;v<ea.n;v++) label[v] = label[uf.find(v)];
+
+    return build_csr(id, ea.src.size(), [&](size_t i, int &u, int &v, int &wt){
+        u = label[ea.src[i]]; v = label[ea.dst[i]]; wt = ea.w[i];
+    });
+}
+
+// Contracts to 'target' vertices and returns the relabeled, folded graph
+inline CsrGraph contract_until_csr(const CsrGraph& g, int target, std::mt19937 &rng){
+    if(target >= g.n) return g;
+
+    EdgeArrays ea = upper_edges(g);
+    CsrUnionFind uf(g.n);
+    contract_csr(ea, target, rng, uf);
+    return quotient_csr(ea, uf);
+}
+
+// ------------------------------------------------------------
+// Indexed binary max-heap over vertices (key, increase-key, pop-max)
+// ------------------------------------------------------------
+struct IndexedMaxHeap {
+    std::vector<int> heap, pos;      // pos[v] = index in heap, -1 if absent
+    std::vector<long long> key;
+
+    void init(int n){
+        heap.clear();
+        pos.assign(n, -1);
+        key.assign(n, 0);
+    }
+    bool empty() const { return heap.empty(); }
+
+    void push(int v, long long k){
+        key[v] = k;
+        pos[v] = heap.size();
+        heap.push_back(v);
+        up(pos[v]);
+    }
+    void increase(int v, long long by){
+        key[v] += by;
+        up(pos[v]);
+    }
+    int pop(){
+        int top = heap[0];
+        pos[top] = -1;
+        int last = heap.back();
+        heap.pop_back();
+        if(!heap.empty()){
+            heap[0] = last;
+            pos[last] = 0;
+            down(0);
+        }
+        return top;
+    }
+    bool contains(int v) const { return pos[v] >= 0; }
+
+private:
+    void up(int i){
+        while(i > 0){
+            int par = (i - 1) / 2;
+            if(key[heap[par]] >= key[heap[i]]) break;
+            swap_at(i, par);
+            i = par;
+        }
+    }
+    void down(int i){
+        int n = heap.size();
+        for(;;){
+            int l = 2*i + 1, r = l + 1, big = i;
+            if(l < n && key[heap[l]] > key[heap[big]]) big = l;
+            if(r < n && key[heap[r]] > key[heap[big]]) big = r;
+            if(big == i) break;
+            swap_at(i, big);
+            i = big;
+        }
+    }
+    void swap_at(int i, int j){
+        std::swap(heap[i], heap[j]);
+        pos[heap[i]] = i;
+        pos[heap[j]] = j;
+    }
+};
+
+// ------------------------------------------------------------
+// Stoer–Wagner on CSR
+// A super-vertex is a chain of vertices (next[]) and owner[] maps a
+// vertex to its chain head, so merging never touches the rows. A phase
+// scans the rows of each popped chain in order, one pass over adj with
+// O(m log n) heap work. Entries inside a chain are dead weight, so once
+// half the vertices have merged away the graph is rebuilt on the
+// survivors (parallel entries folded); that happens O(log n) times.
+// ------------------------------------------------------------
+inline long long stoer_wagner_csr(const CsrGraph& input){
+    if(input.n <= 1) return 0;
+    MINCUT_PHASE(MP_SW);
+
+    const CsrGraph* g = &input;
+    CsrGraph compact;
+
+    int N = 0;
+    std::vector<int> owner, next, tail, size, alive, slot;
+    IndexedMaxHeap heap;
+    auto reset = [&](int n){
+        N = n;
+        owner.resize(n); next.assign(n, -1); tail.resize(n); size.assign(n, 1);
+        alive.resize(n); slot.resize(n);
+        std::iota(owner.begin(), owner.end(), 0);
+        std::iota(tail.begin(), tail.end(), 0);
+        std::iota(alive.begin(), alive.end(), 0);
+        std::iota(slot.begin(), slot.end(), 0);
+        heap.init(n);
+    };
+    reset(g->n);
+
+    long long best = LLONG_MAX;
+
+    while(alive.size() > 1){
+        if(alive.size() * 2 <= (size_t)N){
+            EdgeArrays ea = upper_edges(*g);
+            std::vector<int> label(N);
+            for(size_t k=0;k<alive.size();k++) label[alive[k]] = k;
+            for(int v=0;v<N;v++) label[v] = label[owner[v]];
+            compact = build_csr((int)alive.size(), ea.src.size(), [&](size_t i, int &u, int &v, int &wt){
+                u = label[ea.src[i]]; v = label[ea.dst[i]]; wt = ea.w[i];
+            });
+            g = &compact;
+            reset(compact.n);
+        }
+
+        for(int v : alive) heap.push(v, 0);
+
+        int prev = -1, last = -1;
+        long long last_key = 0;
+        while(!heap.empty()){
+            long long k = heap.key[heap.heap[0]];
+            int v = heap.pop();
+            prev = last;
+            last = v;
+            last_key = k;
+            for(int x = v; x >= 0; x = next[x])
+                for(uint64_t i=g->off[x];i<g->off[x + 1];i++){
+                    int o = owner[g->adj[i]];
+                    if(heap.contains(o)) heap.increase(o, g->w[i]);
+                }
+        }
+
+        best = std::min(best, last_key);
+        if(prev < 0) break;
+
+        // Merge the smaller chain into the larger one
+        int s = prev, t = last;
+        if(size[s] < size[t]) std::swap(s, t);
+        for(int x = t; x >= 0; x = next[x]) owner[x] = s;
+        next[tail[s]] = t;
+        tail[s] = tail[t];
+        size[s] += size[t];
+
+        int back = alive.back();
+        alive[slot[t]] = back;
+        slot[back] = slot[t];
+        alive.pop_back();
+    }
+
+    return best;
+}
+
+#endif
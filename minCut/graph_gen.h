@@ -0,0 +1,279 @@
+// graph_gen.h
+// Random graph generators that cost O(n + m) instead of O(n²).
+//
+//   gen_erdos_skip  G(n, p) by Batagelj–Brandes geometric skipping: the gap
+//                   to the next present pair is Geometric(p), so one draw
+//                   per edge instead of one per pair
+//   gen_sbm         stochastic block model, the same skip run per block pair
+//   gen_power_law   Chung–Lu graph with power-law expected degrees
+//                   (Miller–Hagberg skipping over the sorted weights)
+//
+// Each generator is split into independent chunks with their own RNG
+// stream, so the *_csr versions run the chunks on several threads and
+// write straight into a CsrGraph. The output depends only on the seed and
+// the chunk count, never on the thread count.
+
+#ifndef GRAPH_GEN_H
+#define GRAPH_GEN_H
+
+#include "csr_graph.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using GenEdges = std::vector<std::pair<int,int>>;
+
+namespace graph_gen_detail {
+
+// Uniform in (0, 1], safe to take the log of
+inline double unit_open(std::mt19937 &rng){
+    return 1.0 - std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+}
+
+// Gap before the next success of a Bernoulli(p) sequence, capped so the
+// caller's index arithmetic cannot overflow
+inline double geometric_gap(std::mt19937 &rng, double log_q){
+    double g = std::floor(std::log(unit_open(rng)) / log_q);
+    return std::min(g, 4e18);
+}
+
+// G(n, p) pairs (v, w), w < v, for rows v in [v0, v1)
+inline void erdos_rows(int v0, int v1, double p, std::mt19937 &rng, int offset,
+                       const std::function<void(int,int)> &emit){
+    if(p <= 0) return;
+    if(p >= 1){
+        for(int v=v0;v<v1;v++)
+            for(int w=0;w<v;w++) emit(offset + v, offset + w);
+        return;
+    }
+    double log_q = std::log1p(-p);
+    long long v = std::max(v0, 1), w = -1;
+    while(v < v1){
+        double gap = geometric_gap(rng, log_q);
+        if(gap > (double)v1 * v1) break;
+        w += 1 + (long long)gap;
+        while(w >= v && v < v1){ w -= v; v++; }
+        if(v < v1) emit(offset + (int)v, offset + (int)w);
+    }
+}
+
+// Bipartite pairs between [oa, oa+sa) and [ob, ob+sb), each with probability p
+inline void block_pairs(int oa, int sa, int ob, int sb, double p, std::mt19937 &rng,
+                        const std::function<void(int,int)> &emit){
+    if(p <= 0 || sa == 0 || sb == 0) return;
+    long long total = (long long)sa * sb;
+    if(p >= 1){
+        for(long long i=0;i<total;i++) emit(oa + (int)(i / sb), ob + (int)(i % sb));
+        return;
+    }
+    double log_q = std::log1p(-p);
+    long long i = -1;
+    for(;;){
+        double gap = geometric_gap(rng, log_q);
+        if(i + 1 + gap >= (double)total) break;
+        i += 1 + (long long)gap;
+        emit(oa + (int)(i / sb), ob + (int)(i % sb));
+    }
+}
+
+// Chung–Lu rows u in [u0, u1) over weights sorted in decreasing order
+inline void chung_lu_rows(int u0, int u1, const std::vector<double> &wt, double total,
+                          std::mt19937 &rng, const std::function<void(int,int)> &emit){
+    int n = wt.size();
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    for(int u=u0;u<u1;u++){
+        int v = u + 1;
+        double p = v < n ? std::min(wt[u] * wt[v] / total, 1.0) : 0;
+        while(v < n && p > 0){
+            if(p < 1){
+                double gap = std::floor(std::log(unit_open(rng)) / std::log1p(-p));
+                if(gap >= n - v) break;
+                v += (int)gap;
+            }
+            double q = std::min(wt[u] * wt[v] / total, 1.0);
+            if(U(rng) < q / p) emit(u, v);
+            p = q;
+            v++;
+        }
+    }
+}
+
+// Expected-degree sequence w_i ∝ (i + 1)^(-1/(gamma-1)), scaled to avg_deg
+inline std::vector<double> power_law_weights(int n, double gamma, double avg_deg){
+    std::vector<double> wt(n);
+    double e = 1.0 / (gamma - 1.0), sum = 0;
+    for(int i=0;i<n;i++){ wt[i] = std::pow(i + 1.0, -e); sum += wt[i]; }
+    for(auto &x : wt) x *= avg_deg * n / sum;
+    return wt;
+}
+
+// Runs fn(c) for c in [0, count) on up to 'threads' threads
+inline void parallel_chunks(int count, int threads, const std::function<void(int)> &fn){
+    threads = std::max(1, std::min(threads, count));
+    std::atomic<int> next{0};
+    auto worker = [&]{
+        for(int c; (c = next.fetch_add(1)) < count; ) fn(c);
+    };
+    std::vector<std::thread> pool;
+    for(int t=1;t<threads;t++) pool.emplace_back(worker);
+    worker();
+    for(auto &th : pool) th.join();
+}
+
+// Chunk c's RNG stream
+inline std::mt19937 chunk_rng(uint32_t seed, int c){
+    std::seed_seq seq{seed, (uint32_t)c};
+    return std::mt19937(seq);
+}
+
+} // namespace graph_gen_detail
+
+// ------------------------------------------------------------
+// Sequential generators (edge lists)
+// ------------------------------------------------------------
+inline GenEdges gen_erdos_skip(int n, double p, std::mt19937 &rng){
+    GenEdges edges;
+    edges.reserve((size_t)(p * n * (n - 1.0) / 2 * 1.05) + 16);
+    graph_gen_detail::erdos_rows(0, n, p, rng, 0, [&](int a, int b){ edges.emplace_back(b, a); });
+    return edges;
+}
+
+// Blocks of the given sizes; p_in inside a block, p_out across blocks
+inline GenEdges gen_sbm(const std::vector<int> &sizes, double p_in, double p_out, std::mt19937 &rng){
+    GenEdges edges;
+    auto emit = [&](int a, int b){ edges.emplace_back(std::min(a, b), std::max(a, b)); };
+    int oa = 0;
+    for(size_t a=0;a<sizes.size();a++){
+        graph_gen_detail::erdos_rows(0, sizes[a], p_in, rng, oa, emit);
+        int ob = oa + sizes[a];
+        for(size_t b=a+1;b<sizes.size();b++){
+            graph_gen_detail::block_pairs(oa, sizes[a], ob, sizes[b], p_out, rng, emit);
+            ob += sizes[b];
+        }
+        oa += sizes[a];
+    }
+    return edges;
+}
+
+// Power-law expected degrees with exponent gamma (> 2) and mean avg_deg
+inline GenEdges gen_power_law(int n, double gamma, double avg_deg, std::mt19937 &rng){
+    std::vector<double> wt = graph_gen_detail::power_law_weights(n, gamma, avg_deg);
+    double total = 0;
+    for(double x : wt) total += x;
+    GenEdges edges;
+    edges.reserve((size_t)(avg_deg * n / 2 * 1.1) + 16);
+    graph_gen_detail::chung_lu_rows(0, n, wt, total, rng, [&](int a, int b){ edges.emplace_back(a, b); });
+    return edges;
+}
+
+// ------------------------------------------------------------
+// Parallel generation into CSR
+// Every chunk produces its own edge list. Assembly is then split by
+// vertex range instead of by chunk: each thread scans all chunk lists in
+// order and handles only the endpoints in its own range, so degree counts
+// and row slots need no atomics (locked increments would serialize the
+// cache misses) and row contents come out in the same order for any
+// thread count. The generators above never emit the same pair twice, so
+// rows are only sorted, not folded.
+// ------------------------------------------------------------
+inline CsrGraph csr_from_chunks(int n, int chunks, int threads,
+                                const std::function<void(int, GenEdges&)> &gen){
+    using namespace graph_gen_detail;
+    std::vector<GenEdges> parts(chunks);
+    parallel_chunks(chunks, threads, [&](int c){ gen(c, parts[c]); });
+
+    int ranges = std::max(1, std::min(n, threads));
+    auto range = [&](int r){
+        return std::make_pair((int)((long long)n * r / ranges), (int)((long long)n * (r + 1) / ranges));
+    };
+
+    CsrGraph g;
+    g.n = n;
+    g.off.assign(n + 1, 0);
+    parallel_chunks(ranges, threads, [&](int r){
+        auto [lo, hi] = range(r);
+        for(const auto &part : parts)
+            for(const auto &e : part){
+                if(e.first >= lo && e.first < hi) g.off[e.first + 1]++;
+                if(e.second >= lo && e.second < hi) g.off[e.second + 1]++;
+            }
+    });
+    for(int u=0;u<n;u++) g.off[u + 1] += g.off[u];
+
+    g.adj.resize(g.off[n]);
+    g.w.assign(g.off[n], 1);
+    parallel_chunks(ranges, threads, [&](int r){
+        auto [lo, hi] = range(r);
+        std::vector<uint64_t> pos(g.off.begin() + lo, g.off.begin() + hi);
+        for(const auto &part : parts)
+            for(const auto &e : part){
+                if(e.first >= lo && e.first < hi) g.adj[pos[e.first - lo]++] = e.second;
+                if(e.second >= lo && e.second < hi) g.adj[pos[e.second - lo]++] = e.first;
+            }
+        for(int u=lo;u<hi;u++) std::sort(g.adj.begin() + g.off[u], g.adj.begin() + g.off[u + 1]);
+    });
+    return g;
+}
+
+// G(n, p); chunk boundaries split the n(n-1)/2 pairs evenly
+inline CsrGraph gen_erdos_csr(int n, double p, uint32_t seed, int threads, int chunks = 64){
+    chunks = std::max(1, std::min(chunks, n));
+    return csr_from_chunks(n, chunks, threads, [&](int c, GenEdges &out){
+        int v0 = (int)(n * std::sqrt((double)c / chunks));
+        int v1 = (c + 1 == chunks) ? n : (int)(n * std::sqrt((double)(c + 1) / chunks));
+        std::mt19937 rng = graph_gen_detail::chunk_rng(seed, c);
+        out.reserve((size_t)(p * ((double)v1 * v1 - (double)v0 * v0) / 2 * 1.05) + 16);
+        graph_gen_detail::erdos_rows(v0, v1, p, rng, 0, [&](int a, int b){ out.emplace_back(b, a); });
+    });
+}
+
+// SBM; one chunk per block pair
+inline CsrGraph gen_sbm_csr(const std::vector<int> &sizes, double p_in, double p_out,
+                            uint32_t seed, int threads){
+    int k = sizes.size();
+    std::vector<int> off(k + 1, 0);
+    for(int i=0;i<k;i++) off[i + 1] = off[i] + sizes[i];
+
+    std::vector<std::pair<int,int>> pairs;
+    for(int a=0;a<k;a++)
+        for(int b=a;b<k;b++) pairs.emplace_back(a, b);
+
+    return csr_from_chunks(off[k], pairs.size(), threads, [&](int c, GenEdges &out){
+        auto [a, b] = pairs[c];
+        std::mt19937 rng = graph_gen_detail::chunk_rng(seed, c);
+        auto emit = [&](int x, int y){ out.emplace_back(std::min(x, y), std::max(x, y)); };
+        if(a == b) graph_gen_detail::erdos_rows(0, sizes[a], p_in, rng, off[a], emit);
+        else graph_gen_detail::block_pairs(off[a], sizes[a], off[b], sizes[b], p_out, rng, emit);
+    });
+}
+
+// Chung–Lu; rows are chunked by expected degree mass, not by count
+inline CsrGraph gen_power_law_csr(int n, double gamma, double avg_deg, uint32_t seed,
+                                  int threads, int chunks = 64){
+    std::vector<double> wt = graph_gen_detail::power_law_weights(n, gamma, avg_deg);
+    double total = 0;
+    for(double x : wt) total += x;
+
+    chunks = std::max(1, std::min(chunks, n));
+    std::vector<int> bound(chunks + 1, n);
+    bound[0] = 0;
+    double acc = 0;
+    for(int u=0, c=1; u<n && c<chunks; u++){
+        acc += wt[u];
+        if(acc >= total * c / chunks) bound[c++] = u + 1;
+    }
+
+    return csr_from_chunks(n, chunks, threads, [&](int c, GenEdges &out){
+        std::mt19937 rng = graph_gen_detail::chunk_rng(seed, c);
+        graph_gen_detail::chung_lu_rows(bound[c], bound[c + 1], wt, total, rng,
+                                        [&](int a, int b){ out.emplace_back(a, b); });
+    });
+}
+
+#endif
@@ -0,0 +1,447 @@
+// graph_io.h
+// Graph file loaders shared by karger_batch_ks and karger_mixed_fixed_ks.
+//
+// Supported inputs:
+//   edge list  "u v [w]" per line, 0-based ids, '#' or '%' comment lines
+//   METIS      "n m [fmt [ncon]]" header, then one adjacency line per vertex
+//              (1-based ids, vertex sizes/weights skipped, edge weights kept)
+//   CSR binary the .csr layout below, mapped straight from disk
+//
+// Text files are mmap'd and parsed with a hand-rolled integer parser (no
+// per-line strings, no iostreams). Edge lists take two sequential passes:
+// a memchr newline count to reserve the edge array exactly (so it never
+// reallocates, which would briefly hold two copies), then the parse.
+// GraphData is the loader's own copy; the tools convert it into their
+// engine's layout (weighted edges, CSR) and drop it, so their peak holds
+// both for the length of that conversion. A .csr file loads into a
+// CsrGraph directly from the mapping (load_graph(path, CsrGraph&)), so
+// only the graph itself is ever resident.
+//
+// CSR binary (.csr):
+//   Header (32 bytes):
+//     char     magic[8]   = "MCUTCSR1"
+//     uint32   version    = 1
+//     uint32   flags      (bit 0: weights present)
+//     uint64   n          (vertices)
+//     uint64   nnz        (adjacency entries; every edge is stored twice)
+//   uint64   offsets[n+1]
+//   uint32   adj[nnz]
+//   uint32   weight[nnz]  (only if flags & 1)
+
+#ifndef GRAPH_IO_H
+#define GRAPH_IO_H
+
+#include "csr_graph.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Undirected edge list as loaded from disk (self-loops dropped, each edge once)
+struct GraphData {
+    int n = 0;
+    std::vector<std::pair<int,int>> edges;
+    std::vector<int> weights;               // empty: every edge has weight 1
+    bool weighted() const { return !weights.empty(); }
+};
+
+// Sum of edge weights. The engines keep merged edge weights in 32 bits,
+// so the tools refuse graphs whose total is above INT_MAX: below that no
+// merged weight, and no cut, can wrap.
+inline long long total_weight(const GraphData& g){
+    if(!g.weighted()) return (long long)g.edges.size();
+    long long total = 0;
+    for(int w : g.weights) total += w;
+    return total;
+}
+
+struct CsrFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t n;
+    uint64_t nnz;
+};
+
+static const char CSR_MAGIC[8] = {'M', 'C', 'U', 'T', 'C', 'S', 'R', '1'};
+
+// ------------------------------------------------------------
+// Read-only mapping of a whole file
+// ------------------------------------------------------------
+struct MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile(){ close(); }
+
+    bool open(const std::string& path){
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0) return false;
+        struct stat st;
+        if(fstat(fd, &st) != 0){ ::close(fd); return false; }
+        size = (size_t)st.st_size;
+        if(size == 0){ ::close(fd); data = ""; return true; }
+
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if(p == MAP_FAILED){ size = 0; return false; }
+        madvise(p, size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(p);
+        return true;
+    }
+
+    void close(){
+        if(data && size) munmap(const_cast<char*>(data), size);
+        data = nullptr;
+        size = 0;
+    }
+};
+
+// ------------------------------------------------------------
+// Token scanning over a mapped buffer
+// ------------------------------------------------------------
+namespace graph_io_detail {
+
+inline void skip_blanks(const char*& p, const char* end){
+    while(p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+}
+
+inline void skip_line(const char*& p, const char* end){
+    const void* nl = memchr(p, '\n', end - p);
+    p = nl ? static_cast<const char*>(nl) + 1 : end;
+}
+
+// Parses an unsigned integer at p (after blanks); false if none on this line
+inline bool read_uint(const char*& p, const char* end, uint64_t& out){
+    skip_blanks(p, end);
+    if(p >= end || *p < '0' || *p > '9') return false;
+    uint64_t v = 0;
+    while(p < end && *p >= '0' && *p <= '9') v = v * 10 + (uint64_t)(*p++ - '0');
+    out = v;
+    return true;
+}
+
+inline bool at_line_end(const char*& p, const char* end){
+    skip_blanks(p, end);
+    return p >= end || *p == '\n';
+}
+
+inline size_t count_lines(const char* p, const char* end){
+    size_t lines = 0;
+    while(p < end){
+        const void* nl = memchr(p, '\n', end - p);
+        if(!nl) return lines + 1;
+        lines++;
+        p = static_cast<const char*>(nl) + 1;
+    }
+    return lines;
+}
+
+inline bool has_suffix(const std::string& s, const std::string& suf){
+    return s.size() >= suf.size() && s.compare(s.size() - suf.size(), suf.size(), suf) == 0;
+}
+
+} // namespace graph_io_detail
+
+// ------------------------------------------------------------
+// Edge list: "u v" or "u v w" per line
+// ------------------------------------------------------------
+inline bool load_edge_list(const std::string& path, GraphData& g){
+    using namespace graph_io_detail;
+    MappedFile f;
+    if(!f.open(path)){ std::cerr << "Cannot open " << path << "\n"; return false; }
+
+    const char* p = f.data;
+    const char* end = f.data + f.size;
+
+    g = GraphData();
+    g.edges.reserve(count_lines(p, end));
+
+    uint64_t maxId = 0;
+    bool any = false;
+    bool weighted = false;
+    size_t lineNo = 0;
+
+    while(p < end){
+        lineNo++;
+        skip_blanks(p, end);
+        if(p >= end) break;
+        if(*p == '\n'){ p++; continue; }
+        if(*p == '#' || *p == '%'){ skip_line(p, end); continue; }
+
+        uint64_t u, v, w = 1;
+        if(!read_uint(p, end, u) || !read_uint(p, end, v)){
+            std::cerr << path << ":" << lineNo << ": expected \"u v [w]\"\n";
+            return false;
+        }
+        bool hasW = read_uint(p, end, w);
+        if(!at_line_end(p, end)){
+            std::cerr << path << ":" << lineNo << ": trailing garbage\n";
+            return false;
+        }
+        if(p < end) p++;
+
+        if(u >= INT_MAX || v >= INT_MAX || w > INT_MAX){
+            std::cerr << path << ":" << lineNo << ": value out of range\n";
+            return false;
+        }
+        maxId = std::max(maxId, std::max(u, v));
+        any = true;
+        if(u == v) continue;
+
+        // First weighted line: earlier edges had an implicit weight of 1
+        if(hasW && !weighted){ g.weights.assign(g.edges.size(), 1); weighted = true; }
+        g.edges.emplace_back((int)u, (int)v);
+        if(weighted) g.weights.push_back((int)w);
+    }
+
+    g.n = any ? (int)maxId + 1 : 0;
+    return true;
+}
+
+// ------------------------------------------------------------
+// METIS adjacency format
+// ------------------------------------------------------------
+inline bool load_metis(const std::string& path, GraphData& g){
+    using namespace graph_io_detail;
+    MappedFile f;
+    if(!f.open(path)){ std::cerr << "Cannot open " << path << "\n"; return false; }
+
+    const char* p = f.data;
+    const char* end = f.data + f.size;
+    g = GraphData();
+
+    // Header (after any comment lines)
+    while(p < end && *p == '%') skip_line(p, end);
+    uint64_t n, m, fmtVal = 0, ncon = 0;
+    if(!read_uint(p, end, n) || !read_uint(p, end, m)){
+        std::cerr << path << ": bad METIS header\n";
+        return false;
+    }
+    read_uint(p, end, fmtVal);
+    bool hasCon = read_uint(p, end, ncon);
+    skip_line(p, end);
+
+    // fmt is three binary digits: vertex sizes, vertex weights, edge weights
+    bool hasVsize = (fmtVal / 100) % 10 == 1;
+    bool hasVwgt  = (fmtVal / 10) % 10 == 1;
+    bool hasEwgt  = fmtVal % 10 == 1;
+    if(hasVwgt && !hasCon) ncon = 1;
+    if(!hasVwgt) ncon = 0;
+
+    if(n >= INT_MAX){ std::cerr << path << ": too many vertices\n"; return false; }
+    g.n = (int)n;
+    g.edges.reserve(m);
+    if(hasEwgt) g.weights.reserve(m);
+
+    for(uint64_t u = 0; u < n; u++){
+        while(p < end && *p == '%') skip_line(p, end);
+
+        uint64_t skip;
+        if(hasVsize) read_uint(p, end, skip);
+        for(uint64_t c = 0; c < ncon; c++) read_uint(p, end, skip);
+
+        uint64_t v, w = 1;
+        while(read_uint(p, end, v)){
+            if(hasEwgt && !read_uint(p, end, w)){
+                std::cerr << path << ": vertex " << u + 1 << ": missing edge weight\n";
+                return false;
+            }
+            if(v < 1 || v > n || w > INT_MAX){
+                std::cerr << path << ": vertex " << u + 1 << ": bad neighbor " << v << "\n";
+                return false;
+            }
+            // Each edge is listed from both ends; keep the u < v copy
+            if(v - 1 > u){
+                g.edges.emplace_back((int)u, (int)(v - 1));
+                if(hasEwgt) g.weights.push_back((int)w);
+            }
+        }
+        if(!at_line_end(p, end)){
+            std::cerr << path << ": vertex " << u + 1 << ": unexpected token\n";
+            return false;
+        }
+        if(p < end) p++;
+    }
+
+    if(g.edges.size() != m)
+        std::cerr << path << ": header says " << m << " edges, read " << g.edges.size() << "\n";
+    return true;
+}
+
+// ------------------------------------------------------------
+// CSR binary
+// ------------------------------------------------------------
+inline bool is_csr_file(const std::string& path){
+    std::ifstream in(path, std::ios::binary);
+    char magic[8] = {};
+    in.read(magic, sizeof(magic));
+    return in && memcmp(magic, CSR_MAGIC, sizeof(magic)) == 0;
+}
+
+// Maps a CSR file and checks that its header fits the file. Sizes are
+// compared by division, never by multiplying header fields, so a forged
+// n or nnz cannot wrap the check.
+inline bool map_csr(const std::string& path, MappedFile& f, const CsrFileHeader*& h){
+    if(!f.open(path)){ std::cerr << "Cannot open " << path << "\n"; return false; }
+    if(f.size < sizeof(CsrFileHeader)){ std::cerr << path << ": truncated header\n"; return false; }
+
+    h = reinterpret_cast<const CsrFileHeader*>(f.data);
+    if(memcmp(h->magic, CSR_MAGIC, sizeof(h->magic)) != 0 || h->version != 1){
+        std::cerr << path << ": not a CSR v1 file\n";
+        return false;
+    }
+    uint64_t body = f.size - sizeof(CsrFileHeader);
+    uint64_t per_entry = (h->flags & 1) ? 8 : 4;
+    if(h->n >= INT_MAX || (h->n + 1) > body / 8 || h->nnz > (body - 8 * (h->n + 1)) / per_entry){
+        std::cerr << path << ": truncated body\n";
+        return false;
+    }
+    return true;
+}
+
+inline bool load_csr(const std::string& path, GraphData& g){
+    MappedFile f;
+    const CsrFileHeader* h;
+    if(!map_csr(path, f, h)) return false;
+    bool weighted = h->flags & 1;
+
+    const uint64_t* off = reinterpret_cast<const uint64_t*>(f.data + sizeof(CsrFileHeader));
+    const uint32_t* adj = reinterpret_cast<const uint32_t*>(off + h->n + 1);
+    const uint32_t* wt  = adj + h->nnz;
+
+    g = GraphData();
+    g.n = (int)h->n;
+    g.edges.reserve(h->nnz / 2);
+    if(weighted) g.weights.reserve(h->nnz / 2);
+
+    for(uint64_t u = 0; u < h->n; u++){
+        if(off[u] > off[u+1] || off[u+1] > h->nnz){ std::cerr << path << ": bad offsets\n"; return false; }
+        for(uint64_t i = off[u]; i < off[u+1]; i++){
+            uint32_t v = adj[i];
+            if(v >= h->n){ std::cerr << path << ": bad neighbor\n"; return false; }
+            if(v <= u) continue;
+            g.edges.emplace_back((int)u, (int)v);
+            if(weighted) g.weights.push_back((int)std::min<uint32_t>(wt[i], INT_MAX));
+        }
+    }
+    return true;
+}
+
+// Straight from the mapped arrays into a CsrGraph, with no edge list in
+// between: one pass validates the rows and sizes adj/w exactly, a second
+// copies them (self-loops dropped), then parallel entries are folded.
+// Rows are taken as stored, so the file must list every edge from both
+// ends, as save_csr does. A row whose weights sum past 32 bits is rejected.
+inline bool load_csr(const std::string& path, CsrGraph& g){
+    MappedFile f;
+    const CsrFileHeader* h;
+    if(!map_csr(path, f, h)) return false;
+    bool weighted = h->flags & 1;
+
+    const uint64_t* off = reinterpret_cast<const uint64_t*>(f.data + sizeof(CsrFileHeader));
+    const uint32_t* adj = reinterpret_cast<const uint32_t*>(off + h->n + 1);
+    const uint32_t* wt  = adj + h->nnz;
+
+    g = CsrGraph();
+    g.n = (int)h->n;
+    g.off.assign(h->n + 1, 0);
+    for(uint64_t u = 0; u < h->n; u++){
+        if(off[u] > off[u+1] || off[u+1] > h->nnz){ std::cerr << path << ": bad offsets\n"; return false; }
+        uint64_t sum = 0, len = 0;
+        for(uint64_t i = off[u]; i < off[u+1]; i++){
+            if(adj[i] >= h->n){ std::cerr << path << ": bad neighbor\n"; return false; }
+            if(adj[i] == u) continue;
+            sum += weighted ? wt[i] : 1;
+            len++;
+        }
+        if(sum > UINT32_MAX){ std::cerr << path << ": weighted degree of " << u << " above 2^32\n"; return false; }
+        g.off[u+1] = g.off[u] + len;
+    }
+
+    g.adj.resize(g.off[h->n]);
+    g.w.resize(g.off[h->n]);
+    for(uint64_t u = 0, out = 0; u < h->n; u++)
+        for(uint64_t i = off[u]; i < off[u+1]; i++){
+            if(adj[i] == u) continue;
+            g.adj[out] = adj[i];
+            g.w[out] = weighted ? wt[i] : 1;
+            out++;
+        }
+    fold_csr_rows(g);
+    return true;
+}
+
+inline bool save_csr(const std::string& path, const GraphData& g){
+    std::vector<uint64_t> off(g.n + 1, 0);
+    for(const auto &e : g.edges){ off[e.first + 1]++; off[e.second + 1]++; }
+    for(int i=0;i<g.n;i++) off[i+1] += off[i];
+
+    uint64_t nnz = off[g.n];
+    std::vector<uint32_t> adj(nnz), wt(g.weighted() ? nnz : 0);
+    std::vector<uint64_t> pos(off.begin(), off.end() - 1);
+    for(size_t i=0;i<g.edges.size();i++){
+        int u = g.edges[i].first, v = g.edges[i].second;
+        uint64_t a = pos[u]++, b = pos[v]++;
+        adj[a] = v;
+        adj[b] = u;
+        if(g.weighted()) wt[a] = wt[b] = (uint32_t)g.weights[i];
+    }
+
+    CsrFileHeader h = {};
+    memcpy(h.magic, CSR_MAGIC, sizeof(h.magic));
+    h.version = 1;
+    h.flags = g.weighted() ? 1 : 0;
+    h.n = g.n;
+    h.nnz = nnz;
+
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(reinterpret_cast<const char*>(off.data()), off.size() * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(adj.data()), adj.size() * sizeof(uint32_t));
+    if(g.weighted())
+        out.write(reinterpret_cast<const char*>(wt.data()), wt.size() * sizeof(uint32_t));
+    return (bool)out;
+}
+
+// Picks the loader: CSR by magic, METIS by extension (.graph/.metis),
+// edge list otherwise
+inline bool load_graph(const std::string& path, GraphData& g){
+    using namespace graph_io_detail;
+    if(is_csr_file(path)) return load_csr(path, g);
+    if(has_suffix(path, ".graph") || has_suffix(path, ".metis")) return load_metis(path, g);
+    return load_edge_list(path, g);
+}
+
+// Same dispatch into a CsrGraph. CSR files skip GraphData entirely; text
+// formats still parse into it and convert, refusing a total weight above
+// INT_MAX (see total_weight) before build_csr folds it into 32 bits.
+inline bool load_graph(const std::string& path, CsrGraph& g){
+    if(is_csr_file(path)) return load_csr(path, g);
+
+    GraphData gd;
+    if(!load_graph(path, gd)) return false;
+    if(long long total = total_weight(gd); total > INT_MAX){
+        std::cerr << "Total edge weight " << total << " above " << INT_MAX << "\n";
+        return false;
+    }
+    g = build_csr(gd.n, gd.edges.size(), [&](size_t i, int &u, int &v, int &w){
+        u = gd.edges[i].first; v = gd.edges[i].second;
+        w = gd.weighted() ? gd.weights[i] : 1;
+    });
+    return true;
+}
+
+#endif
@@ -2,8 +2,22 @@
 // Batch experiments for: Karger (single-run), Karger–Stein (recursive), Stoer–Wagner exact.
 // Runs for multiple values of n and trials.
 // Outputs ONE summary row per (n, trials).
+// Build: g++ -O2 -std=c++17 -pthread karger_batch_ks.cpp -o karger_batch_ks
+// Add -DMINCUT_STATS for per-phase timers and counters as extra CSV columns,
+// -DMINCUT_ALLOC_COUNT for the allocation counts in --bench-ks-alloc.
 
 #include <bits/stdc++.h>
+#include "graph_io.h"
+#include "csr_graph.h"
+#include "graph_gen.h"
+#include "mincut_budget.h"
+#include "mincut_file.h"
+#include "mincut_kernel.h"
+#include "mincut_stats.h"
+#include "../common/result_sink.h"
+#include "mincut_treepack.h"
+#include "mincut_weighted.h"
+#include "sw_dense.h"
 using namespace std;
 using Edge = pair<int,int>;
 
@@ -20,7 +34,10 @@ struct DSU {
         iota(p.begin(), p.end(), 0);
         comp = n;
     }
-    int find(int x){ return p[x]==x ? x : p[x] = find(p[x]); }
+    int find(int x){
+        MINCUT_COUNT(dsu_finds, 1);
+        return p[x]==x ? x : p[x] = find(p[x]);
+    }
     bool unite(int a,int b){
         a = find(a); b = find(b);
         if(a==b) return false;
@@ -33,54 +50,116 @@ struct DSU {
 };
 
 // ------------------------------------------------------------
-// Karger single-run
+// Karger single-run (CSR engine, see csr_graph.h)
 // ------------------------------------------------------------
 int karger_once(int n, const vector<Edge>& original_edges, mt19937 &rng){
-    vector<Edge> edges = original_edges;
-    DSU dsu(n);
-
-    while(dsu.comp > 2 && !edges.empty()){
-        uniform_int_distribution<size_t> dist(0, edges.size()-1);
-        size_t idx = dist(rng);
-
-        int u = edges[idx].first;
-        int v = edges[idx].second;
-        int ru = dsu.find(u), rv = dsu.find(v);
-        if(ru == rv){
-            edges[idx] = edges.back();
-            edges.pop_back();
-            continue;
-        }
+    return (int)karger_once_csr(build_csr(n, original_edges), rng);
+}
 
-        dsu.unite(ru, rv);
+// DSU over caller-owned memory (same union-by-rank / path compression as DSU)
+struct DSUView {
+    int *p, *r;
+    int comp;
+    DSUView(int n, int *p_, int *r_) : p(p_), r(r_), comp(n) {
+        iota(p, p + n, 0);
+        fill(r, r + n, 0);
+    }
+    int find(int x){
+        MINCUT_COUNT(dsu_finds, 1);
+        return p[x]==x ? x : p[x] = find(p[x]);
+    }
+    bool unite(int a,int b){
+        a = find(a); b = find(b);
+        if(a==b) return false;
+        if(r[a] < r[b]) swap(a,b);
+        p[b] = a;
+        if(r[a]==r[b]) r[a]++;
+        comp--;
+        return true;
+    }
+};
 
-        vector<Edge> filtered;
-        filtered.reserve(edges.size());
-        for(const auto &e : edges){
-            int a = dsu.find(e.first);
-            int b = dsu.find(e.second);
-            if(a != b) filtered.emplace_back(a,b);
+// ------------------------------------------------------------
+// Permutation contraction
+// Picking a random surviving edge and dropping self-loops as we meet them
+// is the same process as walking a random permutation of the edges and
+// uniting via DSU: a self-loop just fails to unite. Drawing the permutation
+// lazily (partial Fisher–Yates) means every edge is touched at most once,
+// so a run is O(m α(n)) instead of O(m) rescans per merge.
+//
+// Contracts in[0..m) down to 'target' super-vertices and returns how many
+// are left. All memory is the caller's: 'out' has room for m edges and
+// receives the contracted edges (out_m of them, relabeled densely in order
+// of their smallest vertex), p and r hold n ints of DSU state and label n
+// ints of relabel scratch. This is the one contraction loop behind
+// karger_once_fast, contract_until_fast and contract_until_arena.
+// ------------------------------------------------------------
+int contract_perm(int n, const Edge* in, size_t m, int target, mt19937 &rng,
+                  Edge* out, size_t &out_m, int *p, int *r, int *label){
+    { MINCUT_PHASE(MP_COPY); copy(in, in + m, out); }
+    out_m = m;
+    if(target >= n) return n;
+
+    DSUView dsu(n, p, r);
+    size_t left = m;
+    {
+        MINCUT_PHASE(MP_CONTRACT);
+        while(dsu.comp > target && left > 0){
+            uniform_int_distribution<size_t> dist(0, left-1);
+            size_t idx = dist(rng);
+            if(dsu.unite(out[idx].first, out[idx].second)) MINCUT_COUNT(contractions, 1);
+            else MINCUT_COUNT(self_loops, 1);
+            swap(out[idx], out[--left]);
         }
-        edges.swap(filtered);
     }
 
-    int cut = 0;
-    for(const auto &e : original_edges){
-        if(dsu.find(e.first) != dsu.find(e.second)) cut++;
+    MINCUT_PHASE(MP_RELABEL);
+    fill(label, label + n, -1);
+    int id = 0;
+    for(int i=0;i<n;i++){
+        int root = dsu.find(i);
+        if(label[root] < 0) label[root] = id++;
+    }
+
+    // Everything past 'left' was picked, so it is a self-loop by now;
+    // the survivors are compacted to the front in place
+    out_m = 0;
+    for(size_t i=0;i<left;i++){
+        int a = label[ dsu.find(out[i].first) ];
+        int b = label[ dsu.find(out[i].second) ];
+        if(a != b) out[out_m++] = Edge(a,b);
     }
-    return cut;
+    return id;
+}
+
+// ------------------------------------------------------------
+// Karger single-run, permutation engine
+// Contract to two super-vertices: the edges that survive are the cut.
+// ------------------------------------------------------------
+int karger_once_fast(int n, const vector<Edge>& edges, mt19937 &rng){
+    vector<Edge> out(edges.size());
+    vector<int> p(n), r(n), label(n);
+    size_t cut = 0;
+    contract_perm(n, edges.data(), edges.size(), 2, rng, out.data(), cut, p.data(), r.data(), label.data());
+    return (int)cut;
 }
 
 // ------------------------------------------------------------
 // Stoer–Wagner (warning-free version)
+// The m edges come from edge(i, u, v, w), as in stoer_wagner_flat, so the
+// multigraph and the weighted overloads below share this one loop.
 // ------------------------------------------------------------
-int stoer_wagner(int N, const vector<Edge>& edges){
+template<class EdgeFn>
+int stoer_wagner(int N, size_t m, EdgeFn edge){
     if(N <= 1) return 0;
+    MINCUT_PHASE(MP_SW);
 
     vector<vector<int>> w(N, vector<int>(N, 0));
-    for(const auto &e : edges){
-        w[e.first][e.second]++;
-        w[e.second][e.first]++;
+    for(size_t i=0;i<m;i++){
+        int a, b, wt;
+        edge(i, a, b, wt);
+        w[a][b] += wt;
+        w[b][a] += wt;
     }
 
     vector<int> v(N);
@@ -136,66 +215,103 @@ int stoer_wagner(int N, const vector<Edge>& edges){
     return best;
 }
 
-// ------------------------------------------------------------
-// Karger–Stein: contract-until stage
-// ------------------------------------------------------------
-pair<int, vector<Edge>>
-contract_until(int n, const vector<Edge>& original, int target, mt19937 &rng){
-    if(target >= n) return {n, original};
+int stoer_wagner(int N, const vector<Edge>& edges){
+    return stoer_wagner(N, edges.size(), [&](size_t i, int &u, int &v, int &w){
+        u = edges[i].first; v = edges[i].second; w = 1;
+    });
+}
 
-    vector<Edge> edges = original;
-    DSU dsu(n);
+int stoer_wagner(int N, const vector<WEdge>& edges){
+    return stoer_wagner(N, edges.size(), [&](size_t i, int &u, int &v, int &w){
+        u = edges[i].u; v = edges[i].v; w = edges[i].w;
+    });
+}
 
-    while(dsu.comp > target){
-        uniform_int_distribution<size_t> dist(0, edges.size()-1);
-        size_t idx = dist(rng);
+// Multigraph to unique weighted pairs; the WEdge engines these overloads
+// wrap live in mincut_weighted.h
+vector<WEdge> to_weighted(const vector<Edge>& edges){
+    vector<WEdge> w;
+    w.reserve(edges.size());
+    for(const auto &e : edges) w.push_back({e.first, e.second, 1});
+    return merge_parallel(move(w));
+}
 
-        int u = edges[idx].first;
-        int v = edges[idx].second;
+// ------------------------------------------------------------
+// Stoer–Wagner, sparse (CSR + indexed heap, see csr_graph.h)
+// Each phase is a maximum-adjacency ordering driven by the heap, so it
+// costs O(m log n) instead of O(n²), and memory is O(n + m) instead of
+// the n×n matrix.
+// ------------------------------------------------------------
+long long stoer_wagner_sparse(int N, const vector<Edge>& edges){
+    return stoer_wagner_sparse(N, to_weighted(edges));
+}
 
-        int ru = dsu.find(u), rv = dsu.find(v);
-        if(ru == rv){
-            edges[idx] = edges.back();
-            edges.pop_back();
-            continue;
-        }
+// ------------------------------------------------------------
+// Stoer–Wagner, dense on the flat matrix (sw_dense.h)
+// Same algorithm as stoer_wagner, with physical compaction on merge and
+// AVX2 update/argmax. Used for the Karger–Stein base cases and the dense
+// side of stoer_wagner_auto; stoer_wagner stays as the reference.
+// ------------------------------------------------------------
+int stoer_wagner_flat(int N, const vector<Edge>& edges, bool simd = true){
+    return stoer_wagner_flat(N, edges.size(), [&](size_t i, int &u, int &v, int &w){
+        u = edges[i].first; v = edges[i].second; w = 1;
+    }, simd);
+}
 
-        dsu.unite(ru, rv);
+// Picks the engine by density: the flat O(n³) version wins on dense and
+// mid-density graphs, the heap version on sparse ones (and it is the only
+// one whose memory doesn't blow up at large n). Parallel edges are
+// merged first, so a multigraph is judged by its unique pairs.
+long long stoer_wagner_auto(int N, const vector<Edge>& edges){
+    return stoer_wagner_auto(N, to_weighted(edges));
+}
 
-        vector<Edge> filtered;
-        filtered.reserve(edges.size());
-        for(const auto &e : edges){
-            int a = dsu.find(e.first);
-            int b = dsu.find(e.second);
-            if(a != b) filtered.emplace_back(a,b);
-        }
-        edges.swap(filtered);
-    }
+// ------------------------------------------------------------
+// Karger–Stein: contract-until stage
+// ------------------------------------------------------------
+pair<int, vector<Edge>>
+contract_until(int n, const vector<Edge>& original, int target, mt19937 &rng){
+    if(target >= n) return {n, original};
 
-    unordered_map<int,int> mp;
-    int id = 0;
-    for(int i=0;i<n;i++){
-        int r = dsu.find(i);
-        if(!mp.count(r)) mp[r] = id++;
-    }
+    CsrGraph g = contract_until_csr(build_csr(n, original), target, rng);
 
+    // Back to a multigraph: an entry of weight w is w parallel edges
+    MINCUT_PHASE(MP_COPY);
     vector<Edge> new_edges;
-    new_edges.reserve(edges.size());
-    for(const auto &e : edges){
-        int a = mp[ dsu.find(e.first) ];
-        int b = mp[ dsu.find(e.second) ];
-        if(a != b) new_edges.emplace_back(a,b);
-    }
+    new_edges.reserve(original.size());
+    for(int u=0;u<g.n;u++)
+        for(uint64_t i=g.off[u];i<g.off[u+1];i++)
+            if((int)g.adj[i] > u)
+                for(uint32_t c=0;c<g.w[i];c++) new_edges.emplace_back(u, g.adj[i]);
 
-    return {id, new_edges};
+    return {g.n, new_edges};
+}
+
+// ------------------------------------------------------------
+// Karger–Stein: contract-until stage, permutation engine
+// contract_perm on fresh vectors, allocated on every call
+// ------------------------------------------------------------
+pair<int, vector<Edge>>
+contract_until_fast(int n, const vector<Edge>& original, int target, mt19937 &rng){
+    vector<Edge> out(original.size());
+    vector<int> p(n), r(n), label(n);
+    size_t out_m = 0;
+    int k = contract_perm(n, original.data(), original.size(), target, rng,
+                          out.data(), out_m, p.data(), r.data(), label.data());
+    out.resize(out_m);
+    return {k, out};
 }
 
 // ------------------------------------------------------------
 // Karger–Stein recursive
+// Heap-allocated reference: every node contracts into fresh vectors
+// (contract_until_fast). The one reference recursion, kept for
+// --bench-ks-alloc, which checks the arena version below against it.
 // ------------------------------------------------------------
 int karger_stein_rec(int n, const vector<Edge>& edges, mt19937 &rng){
+    MINCUT_COUNT(rec_nodes, 1);
     if(n <= 20)
-        return stoer_wagner(n, edges);
+        return stoer_wagner_flat(n, edges);
 
     int t = (int)ceil(n / sqrt(2.0));
 
@@ -203,8 +319,8 @@ int karger_stein_rec(int n, const vector<Edge>& edges, mt19937 &rng){
     uint32_t s2 = rng();
     mt19937 r1(s1), r2(s2);
 
-    auto [n1, e1] = contract_until(n, edges, t, r1);
-    auto [n2, e2] = contract_until(n, edges, t, r2);
+    auto [n1, e1] = contract_until_fast(n, edges, t, r1);
+    auto [n2, e2] = contract_until_fast(n, edges, t, r2);
 
     int c1 = karger_stein_rec(n1, e1, r1);
     int c2 = karger_stein_rec(n2, e2, r2);
@@ -212,14 +328,133 @@ int karger_stein_rec(int n, const vector<Edge>& edges, mt19937 &rng){
     return min(c1, c2);
 }
 
+// ------------------------------------------------------------
+// Bump arena for Karger–Stein
+// Memory comes from large blocks and is handed back in LIFO order by
+// rewinding to a mark, which matches the recursion exactly: a node takes
+// its buffers on entry and releases them on exit. Blocks are kept, so after
+// the first descent a whole Karger–Stein run does no heap allocation.
+// ------------------------------------------------------------
+struct BumpArena {
+    static constexpr size_t BLOCK = 1 << 20;
+
+    vector<unique_ptr<char[]>> blocks;
+    vector<size_t> sizes;
+    size_t cur = 0, off = 0;
+
+    struct Mark { size_t cur, off; };
+    Mark mark() const { return {cur, off}; }
+    void release(Mark m){ cur = m.cur; off = m.off; }
+
+    template<class T>
+    T* alloc(size_t count){
+        size_t bytes = count * sizeof(T);
+        for(;;){
+            if(cur < blocks.size()){
+                size_t start = (off + alignof(T) - 1) & ~(alignof(T) - 1);
+                if(start + bytes <= sizes[cur]){
+                    off = start + bytes;
+                    return reinterpret_cast<T*>(blocks[cur].get() + start);
+                }
+                if(off != 0){
+                    // Rest of this block is too small: continue in the next one
+                    cur++; off = 0;
+                    continue;
+                }
+            }
+            // No (big enough) free block here: insert one at 'cur'. Blocks
+            // from 'cur' on are all free, so nothing live moves.
+            size_t sz = max(BLOCK, bytes);
+            blocks.insert(blocks.begin() + cur, unique_ptr<char[]>(new char[sz]));
+            sizes.insert(sizes.begin() + cur, sz);
+            off = 0;
+        }
+    }
+};
+
+// contract_perm on arena memory: its DSU and relabel scratch come from A
+// and are released on return. 'out' must already hold room for m edges
+// (allocated by the caller, below this scratch).
+int contract_until_arena(int n, const Edge* in, size_t m, int target, mt19937 &rng,
+                         BumpArena &A, Edge* out, size_t &out_m){
+    auto M = A.mark();
+    int *p = A.alloc<int>(n), *r = A.alloc<int>(n), *label = A.alloc<int>(n);
+    int k = contract_perm(n, in, m, target, rng, out, out_m, p, r, label);
+    A.release(M);
+    return k;
+}
+
+// Karger–Stein on the arena. Branch 1 is contracted and fully explored
+// before branch 2 is contracted; r1 and r2 are independent streams, so
+// this returns exactly what karger_stein_rec does, with half the peak memory.
+//
+// The top 'fork_depth' levels run branch 1 in an async task instead, on a
+// BumpArena of its own, while branch 2 stays on A in the current thread:
+// up to 2^fork_depth tasks in flight. A task's arena is rewound by its
+// recursion like any other, so forking adds one arena per task and no
+// per-node allocation. The result depends only on the seed, never on
+// fork_depth or scheduling.
+int karger_stein_arena_rec(int n, const Edge* edges, size_t m, mt19937 &rng, BumpArena &A,
+                           int fork_depth = 0){
+    MINCUT_COUNT(rec_nodes, 1);
+    if(n <= 20)
+        return stoer_wagner_flat(n, m, [&](size_t i, int &u, int &v, int &w){
+            u = edges[i].first; v = edges[i].second; w = 1;
+        });
+
+    int t = (int)ceil(n / sqrt(2.0));
+
+    uint32_t s1 = rng();
+    uint32_t s2 = rng();
+    mt19937 r1(s1), r2(s2);
+
+    auto branch = [&](mt19937 &r, BumpArena &B){
+        auto M = B.mark();
+        Edge *sub = B.alloc<Edge>(m);
+        size_t sub_m = 0;
+        int n1 = contract_until_arena(n, edges, m, t, r, B, sub, sub_m);
+        int c = karger_stein_arena_rec(n1, sub, sub_m, r, B, max(fork_depth - 1, 0));
+        B.release(M);
+        return c;
+    };
+
+    if(fork_depth > 0){
+        auto f = async(launch::async, [&]{
+            BumpArena child;
+            return branch(r1, child);
+        });
+        int c2 = branch(r2, A);
+        return min(f.get(), c2);
+    }
+
+    int c1 = branch(r1, A);
+    int c2 = branch(r2, A);
+    return min(c1, c2);
+}
+
 int karger_stein(int n, const vector<Edge>& edges, mt19937 &rng){
-    return karger_stein_rec(n, edges, rng);
+    // One arena per thread, reused across trials
+    thread_local BumpArena arena;
+    return karger_stein_arena_rec(n, edges.data(), edges.size(), rng, arena);
+}
+
+// Karger–Stein, task-parallel: karger_stein with the top fork_depth
+// levels forked (see karger_stein_arena_rec)
+int karger_stein_par(int n, const vector<Edge>& edges, mt19937 &rng, int fork_depth){
+    thread_local BumpArena arena;
+    return karger_stein_arena_rec(n, edges.data(), edges.size(), rng, arena, fork_depth);
 }
 
 // ------------------------------------------------------------
 // Graph Generators
 // ------------------------------------------------------------
+// G(n, p) by geometric skipping (graph_gen.h): O(n + m), not O(n²)
 vector<Edge> gen_erdos(int n, double p, mt19937 &rng){
+    return gen_erdos_skip(n, p, rng);
+}
+
+// One draw per pair; kept as the reference for --bench-gen
+vector<Edge> gen_erdos_pairwise(int n, double p, mt19937 &rng){
     vector<Edge> edges;
     uniform_real_distribution<double> ud(0, 1);
     for(int i=0;i<n;i++)
@@ -258,14 +493,15 @@ struct Summary {
 
     double erdos_k_ms,     clique_k_ms;
     double erdos_ks_ms,    clique_ks_ms;
+
+    // Totals over all trials (zero unless built with MINCUT_STATS)
+    MincutStats setup, karger, ks;
 };
 
 // ------------------------------------------------------------
-// Run ONE experiment configuration (n, trials)
+// Per-thread accumulator for the Summary fields
 // ------------------------------------------------------------
-Summary run_experiment(int n, int trials, int k, double p, unsigned seed){
-    mt19937 rng(seed);
-
+struct Accum {
     int ke = 0, kc = 0;
     int kse = 0, ksc = 0;
     int ned = 0, ncl = 0;
@@ -273,80 +509,703 @@ Summary run_experiment(int n, int trials, int k, double p, unsigned seed){
     double ke_time = 0, kc_time = 0;
     double kse_time = 0, ksc_time = 0;
 
-    for(int t=0;t<trials;t++){
-        uint32_t s = rng();
-        mt19937 local(s);
+    MincutStats setup{}, karger{}, ks{};
+
+    void merge(const Accum &o){
+        ke += o.ke;   kc += o.kc;
+        kse += o.kse; ksc += o.ksc;
+        ned += o.ned; ncl += o.ncl;
+        ke_time += o.ke_time;   kc_time += o.kc_time;
+        kse_time += o.kse_time; ksc_time += o.ksc_time;
+        setup.merge(o.setup); karger.merge(o.karger); ks.merge(o.ks);
+    }
+};
+
+// ------------------------------------------------------------
+// ONE trial: everything is driven by its own seed, so trials are
+// independent and can run in any order / on any thread.
+// ------------------------------------------------------------
+void run_trial(int n, int k, double p, uint32_t s, Accum &A){
+    mt19937 local(s);
+    mincut_stats_take();
+
+    bool isErdos = (local() & 1);
+    vector<Edge> edges;
+    {
+        MINCUT_PHASE(MP_GEN);
+        edges = isErdos ? gen_erdos(n, p, local) : gen_clique(n, k, local);
+    }
+
+    int true_cut = stoer_wagner_auto(n, edges);
+    A.setup.merge(mincut_stats_take());
+
+    // ----- KARGER -----
+    auto t0 = chrono::high_resolution_clock::now();
+    int c1 = karger_once(n, edges, local);
+    auto t1 = chrono::high_resolution_clock::now();
+    double ms1 = chrono::duration<double,milli>(t1-t0).count();
+    A.karger.merge(mincut_stats_take());
+
+    // ----- KARGER–STEIN -----
+    auto t2 = chrono::high_resolution_clock::now();
+    int c2 = karger_stein(n, edges, local);
+    auto t3 = chrono::high_resolution_clock::now();
+    double ms2 = chrono::duration<double,milli>(t3-t2).count();
+    A.ks.merge(mincut_stats_take());
+
+    if(isErdos){
+        A.ned++;
+        A.ke_time += ms1;
+        A.kse_time += ms2;
+        if(c1 == true_cut) A.ke++;
+        if(c2 == true_cut) A.kse++;
+    } else {
+        A.ncl++;
+        A.kc_time += ms1;
+        A.ksc_time += ms2;
+        if(c1 == true_cut) A.kc++;
+        if(c2 == true_cut) A.ksc++;
+    }
+}
+
+// ------------------------------------------------------------
+// Run ONE experiment configuration (n, trials)
+// The per-trial seeds are drawn up front from the master rng in the same
+// order as the sequential loop, then trials are handed out to 'threads'
+// workers. Each worker keeps its own Accum; the counts are merged exactly,
+// so the accuracy columns match a single-threaded run bit for bit.
+// (The *_ms columns are wall-clock measurements and vary run to run anyway.)
+// ------------------------------------------------------------
+Summary run_experiment(int n, int trials, int k, double p, unsigned seed, int threads = 1){
+    mt19937 rng(seed);
+
+    vector<uint32_t> seeds(trials);
+    for(int t=0;t<trials;t++) seeds[t] = rng();
+
+    threads = max(1, min(threads, trials));
+    vector<Accum> acc(threads);
+    atomic<int> next(0);
+
+    auto worker = [&](int id){
+        for(int t; (t = next.fetch_add(1)) < trials; )
+            run_trial(n, k, p, seeds[t], acc[id]);
+    };
+
+    if(threads == 1){
+        worker(0);
+    } else {
+        vector<thread> pool;
+        for(int i=0;i<threads;i++) pool.emplace_back(worker, i);
+        for(auto &th : pool) th.join();
+    }
+
+    Accum A;
+    for(const auto &a : acc) A.merge(a);
+
+    Summary S;
+
+    S.erdos_k_acc  = A.ned ? (double)A.ke / A.ned : 0;
+    S.erdos_ks_acc = A.ned ? (double)A.kse / A.ned : 0;
+    S.clique_k_acc = A.ncl ? (double)A.kc / A.ncl : 0;
+    S.clique_ks_acc= A.ncl ? (double)A.ksc / A.ncl : 0;
 
-        bool isErdos = (local() & 1);
-        vector<Edge> edges =
-            isErdos ? gen_erdos(n, p, local) : gen_clique(n, k, local);
+    S.combined_k_acc  = (double)(A.ke + A.kc)  / trials;
+    S.combined_ks_acc = (double)(A.kse + A.ksc)/ trials;
 
-        int true_cut = stoer_wagner(n, edges);
+    S.erdos_k_ms  = A.ned ? A.ke_time / A.ned : 0;
+    S.erdos_ks_ms = A.ned ? A.kse_time / A.ned : 0;
+    S.clique_k_ms = A.ncl ? A.kc_time / A.ncl : 0;
+    S.clique_ks_ms= A.ncl ? A.ksc_time / A.ncl : 0;
+
+    S.setup = A.setup;
+    S.karger = A.karger;
+    S.ks = A.ks;
+
+    return S;
+}
+
+// ------------------------------------------------------------
+// Contraction benchmark: CSR engine vs permutation engine
+// Sparse Erdős graphs use p = 10/n (average degree ~10) so that large n
+// stays generatable. The CSR timings include building the CSR.
+// ------------------------------------------------------------
+void bench_contract(const string &out){
+    ofstream fout(out);
+    fout << "graph,n,m,"
+         << "csr_karger_ms,perm_karger_ms,"
+         << "csr_contract_ms,perm_contract_ms,"
+         << "karger_ratio,contract_ratio\n";
+
+    const int REPS = 3;
+
+    vector<pair<string,int>> configs = {
+        {"erdos", 1000}, {"erdos", 10000}, {"erdos", 30000}, {"erdos", 100000},
+        {"clique", 100}, {"clique", 200}, {"clique", 500}, {"clique", 1000}
+    };
+
+    for(auto &[graph, n] : configs){
+        mt19937 rng(4242 + n);
+        vector<Edge> edges = (graph == "erdos")
+            ? gen_erdos(n, 10.0 / n, rng)
+            : gen_clique(n, 5, rng);
+        int t = (int)ceil(n / sqrt(2.0));
+
+        auto time_ms = [&](auto &&fn){
+            double total = 0;
+            for(int r=0;r<REPS;r++){
+                mt19937 local(r);
+                auto t0 = chrono::high_resolution_clock::now();
+                fn(local);
+                auto t1 = chrono::high_resolution_clock::now();
+                total += chrono::duration<double,milli>(t1-t0).count();
+            }
+            return total / REPS;
+        };
+
+        double perm_k = time_ms([&](mt19937 &r){ karger_once_fast(n, edges, r); });
+        double perm_c = time_ms([&](mt19937 &r){ contract_until_fast(n, edges, t, r); });
+        double csr_k = time_ms([&](mt19937 &r){ karger_once(n, edges, r); });
+        double csr_c = time_ms([&](mt19937 &r){ contract_until(n, edges, t, r); });
+
+        cout << graph << " n=" << n << " m=" << edges.size()
+             << " karger csr=" << csr_k << "ms perm=" << perm_k << "ms"
+             << " contract csr=" << csr_c << "ms perm=" << perm_c << "ms\n";
+
+        fout << graph << "," << n << "," << edges.size() << ","
+             << csr_k << "," << perm_k << ","
+             << csr_c << "," << perm_c << ","
+             << csr_k / perm_k << "," << csr_c / perm_c << "\n";
+    }
+
+    fout.close();
+    cout << "Saved: " << out << "\n";
+}
+
+// ------------------------------------------------------------
+// Parallel Karger–Stein benchmark: one min-cut query on a large graph,
+// timed for fork depths 0..4 (1..16 tasks) against the sequential
+// karger_stein. Cuts must agree across fork depths for the same seed.
+// ------------------------------------------------------------
+void bench_ks_par(const string &out){
+    ofstream fout(out);
+    fout << "graph,n,m,fork_depth,tasks,hw_threads,ms,cut,speedup_vs_depth0,seq_ks_ms\n";
+
+    const int REPS = 3;
+    unsigned hw = max(1u, thread::hardware_concurrency());
+
+    vector<pair<string,int>> configs = { {"erdos", 400}, {"clique", 200} };
+
+    for(auto &[graph, n] : configs){
+        mt19937 rng(777 + n);
+        vector<Edge> edges = (graph == "erdos")
+            ? gen_erdos(n, 0.1, rng)
+            : gen_clique(n, 5, rng);
+
+        double seq_ms = 0;
+        for(int r=0;r<REPS;r++){
+            mt19937 local(r);
+            auto t0 = chrono::high_resolution_clock::now();
+            karger_stein(n, edges, local);
+            auto t1 = chrono::high_resolution_clock::now();
+            seq_ms += chrono::duration<double,milli>(t1-t0).count() / REPS;
+        }
+
+        double base_ms = 0;
+        for(int d=0; d<=4; d++){
+            double ms = 0;
+            int cut = -1;
+            for(int r=0;r<REPS;r++){
+                mt19937 local(r);
+                auto t0 = chrono::high_resolution_clock::now();
+                int c = karger_stein_par(n, edges, local, d);
+                auto t1 = chrono::high_resolution_clock::now();
+                ms += chrono::duration<double,milli>(t1-t0).count() / REPS;
+                if(r == 0) cut = c;
+            }
+            if(d == 0) base_ms = ms;
+
+            cout << graph << " n=" << n << " fork_depth=" << d
+                 << " ms=" << ms << " cut=" << cut
+                 << " (sequential karger_stein " << seq_ms << "ms)\n";
+
+            fout << graph << "," << n << "," << edges.size() << ","
+                 << d << "," << (1 << d) << "," << hw << ","
+                 << ms << "," << cut << "," << base_ms / ms << ","
+                 << seq_ms << "\n";
+        }
+    }
+
+    fout.close();
+    cout << "Saved: " << out << "\n";
+}
+
+// ------------------------------------------------------------
+// Stoer–Wagner benchmark: dense matrix vs flat matrix (AVX2 and scalar)
+// vs adjacency-list/heap engine on sparse Erdős graphs (p = 10/n) and on
+// dense cliques. The matrix engines are skipped (-1) once the n×n matrix
+// gets too big; small graphs (the Karger–Stein base case size) are timed
+// over many repetitions.
+// ------------------------------------------------------------
+void bench_sw(const string &out){
+    ofstream fout(out);
+    fout << "graph,n,m,dense_ms,flat_ms,flat_scalar_ms,sparse_ms,auto_engine,cut,cuts_match\n";
+
+    vector<pair<string,int>> configs = {
+        {"erdos", 200}, {"erdos", 500}, {"erdos", 1000}, {"erdos", 2000}, {"erdos", 5000},
+        {"clique", 20}, {"clique", 50}, {"clique", 100}, {"clique", 200}, {"clique", 400}
+    };
+
+    for(auto &[graph, n] : configs){
+        mt19937 rng(31 + n);
+        vector<Edge> edges = (graph == "erdos")
+            ? gen_erdos(n, 10.0 / n, rng)
+            : gen_clique(n, 5, rng);
+
+        int reps = n <= 50 ? 2000 : 1;
+        auto time_ms = [&](auto &&fn, int &cut){
+            auto t0 = chrono::high_resolution_clock::now();
+            for(int r=0;r<reps;r++) cut = fn();
+            auto t1 = chrono::high_resolution_clock::now();
+            return chrono::duration<double,milli>(t1-t0).count() / reps;
+        };
+
+        int cs = 0;
+        double sparse_ms = time_ms([&]{ return stoer_wagner_sparse(n, edges); }, cs);
+
+        double dense_ms = -1, flat_ms = -1, scalar_ms = -1;
+        bool match = true;
+        if(n <= 2000){
+            int cd = 0, cf = 0, cv = 0;
+            dense_ms = time_ms([&]{ return stoer_wagner(n, edges); }, cd);
+            flat_ms = time_ms([&]{ return stoer_wagner_flat(n, edges); }, cf);
+            scalar_ms = time_ms([&]{ return stoer_wagner_flat(n, edges, false); }, cv);
+            match = cd == cs && cf == cs && cv == cs;
+        }
+
+        bool sparse_pick = sw_prefers_sparse(n, to_weighted(edges).size());
+
+        cout << graph << " n=" << n << " m=" << edges.size()
+             << " dense=" << dense_ms << "ms flat=" << flat_ms << "ms scalar=" << scalar_ms
+             << "ms sparse=" << sparse_ms << "ms"
+             << " cut=" << cs << (match ? "" : "  CUT MISMATCH") << "\n";
+
+        fout << graph << "," << n << "," << edges.size() << ","
+             << dense_ms << "," << flat_ms << "," << scalar_ms << "," << sparse_ms << ","
+             << (sparse_pick ? "sparse" : "dense") << ","
+             << cs << "," << match << "\n";
+    }
+
+    fout.close();
+    cout << "Saved: " << out << "\n";
+}
+
+// ------------------------------------------------------------
+// Weighted vs. multigraph engines (--bench-weighted)
+// The same graph with k parallel copies per edge: the multigraph engines
+// see k*m edges, the weighted ones see m.
+// ------------------------------------------------------------
+void bench_weighted(const string &out){
+    ofstream fout(out);
+    fout << "n,copies,multi_edges,weighted_edges,algo,multi_ms,weighted_ms,multi_cut,weighted_cut\n";
+
+    const int TRIALS = 20;
+    vector<pair<int,int>> configs = { {40, 1}, {40, 8}, {80, 8}, {80, 32}, {160, 16} };
+
+    for(auto [n, copies] : configs){
+        mt19937 gen(77 + n + copies);
+        vector<Edge> base = gen_clique(n, 3, gen);
+        vector<Edge> multi;
+        multi.reserve(base.size() * copies);
+        for(int c=0;c<copies;c++) multi.insert(multi.end(), base.begin(), base.end());
+        shuffle(multi.begin(), multi.end(), gen);
 
-        // ----- KARGER -----
         auto t0 = chrono::high_resolution_clock::now();
-        int c1 = karger_once(n, edges, local);
+        vector<WEdge> weighted = to_weighted(multi);
         auto t1 = chrono::high_resolution_clock::now();
-        double ms1 = chrono::duration<double,milli>(t1-t0).count();
+        double merge_ms = chrono::duration<double,milli>(t1-t0).count();
+
+        auto time_ms = [](auto &&fn, int &result){
+            auto a = chrono::high_resolution_clock::now();
+            result = fn();
+            auto b = chrono::high_resolution_clock::now();
+            return chrono::duration<double,milli>(b-a).count();
+        };
+
+        auto emit = [&](const string &algo, double mm, double wm, int mc, int wc){
+            cout << "n=" << n << " copies=" << copies << " " << algo
+                 << " multi=" << mm << "ms weighted=" << wm << "ms"
+                 << " cut=" << mc << "/" << wc << "\n";
+            fout << n << "," << copies << "," << multi.size() << "," << weighted.size() << ","
+                 << algo << "," << mm << "," << wm << "," << mc << "," << wc << "\n";
+        };
+
+        int mc, wc;
+        double mm = time_ms([&]{ return stoer_wagner(n, multi); }, mc);
+        double wm = merge_ms + time_ms([&]{ return stoer_wagner(n, weighted); }, wc);
+        emit("stoer_wagner", mm, wm, mc, wc);
+
+        mm = time_ms([&]{
+            mt19937 r(5); int best = INT_MAX;
+            for(int t=0;t<TRIALS;t++) best = min(best, karger_once_fast(n, multi, r));
+            return best;
+        }, mc);
+        wm = merge_ms + time_ms([&]{
+            mt19937 r(5); long long best = LLONG_MAX;
+            for(int t=0;t<TRIALS;t++) best = min(best, karger_once_weighted(n, weighted, r));
+            return best;
+        }, wc);
+        emit("karger", mm, wm, mc, wc);
+
+        mm = time_ms([&]{ mt19937 r(9); return karger_stein(n, multi, r); }, mc);
+        wm = merge_ms + time_ms([&]{ mt19937 r(9); return karger_stein_weighted(n, weighted, r); }, wc);
+        emit("karger_stein", mm, wm, mc, wc);
+    }
 
-        // ----- KARGER–STEIN -----
+    fout.close();
+    cout << "Saved: " << out << "\n";
+}
+
+// ------------------------------------------------------------
+// Generator benchmark (--bench-gen)
+// Average degree ~10 throughout. The pairwise G(n, p) loop is O(n²), so it
+// only runs up to n = 30000 (-1 beyond); the skip generators are O(n + m).
+// SBM: 4 equal blocks, p_in = 30/n, p_out = 2/n. Power law: gamma = 2.5.
+// ------------------------------------------------------------
+void bench_gen(const string &out){
+    ofstream fout(out);
+    fout << "generator,n,m,threads,ms\n";
+
+    int threads = (int)max(1u, thread::hardware_concurrency());
+    vector<int> sizes_n = {1000, 10000, 100000, 1000000, 4000000};
+
+    auto time_ms = [](auto &&fn){
+        auto t0 = chrono::high_resolution_clock::now();
+        size_t m = fn();
+        auto t1 = chrono::high_resolution_clock::now();
+        return make_pair(m, chrono::duration<double,milli>(t1-t0).count());
+    };
+    auto emit = [&](const string &gen, int n, int th, pair<size_t,double> r){
+        cout << gen << " n=" << n << " m=" << r.first << " threads=" << th
+             << " " << r.second << "ms\n";
+        fout << gen << "," << n << "," << r.first << "," << th << "," << r.second << "\n";
+    };
+
+    for(int n : sizes_n){
+        double p = 10.0 / n;
+        mt19937 rng(2024 + n);
+
+        if(n <= 30000)
+            emit("erdos_pairwise", n, 1, time_ms([&]{ return gen_erdos_pairwise(n, p, rng).size(); }));
+        emit("erdos_skip", n, 1, time_ms([&]{ return gen_erdos(n, p, rng).size(); }));
+        emit("erdos_csr", n, threads, time_ms([&]{ return gen_erdos_csr(n, p, 7, threads).edges(); }));
+
+        vector<int> blocks(4, n / 4);
+        blocks[3] += n % 4;
+        emit("sbm_csr", n, threads,
+             time_ms([&]{ return gen_sbm_csr(blocks, 30.0 / n, 2.0 / n, 7, threads).edges(); }));
+        emit("power_law_csr", n, threads,
+             time_ms([&]{ return gen_power_law_csr(n, 2.5, 10.0, 7, threads).edges(); }));
+    }
+
+    fout.close();
+    cout << "Saved: " << out << "\n";
+}
+
+// ------------------------------------------------------------
+// Kernelization benchmark (--bench-kernel)
+// Exact Stoer–Wagner on the raw graph vs. kernelize + Stoer–Wagner on the
+// kernel; the two cuts must agree.
+// ------------------------------------------------------------
+void bench_kernel(const string &out){
+    ofstream fout(out);
+    fout << "graph,n,m,kernel_n,kernel_m,raw_ms,kernel_ms,solve_ms,cut,cuts_match\n";
+
+    struct Config { string graph; int n; };
+    vector<Config> configs = {
+        {"erdos", 1000}, {"erdos", 5000}, {"clique", 200}, {"clique", 400},
+        {"sbm", 2000}, {"power_law", 5000}, {"power_law", 20000}
+    };
+
+    for(const auto &c : configs){
+        mt19937 rng(99 + c.n);
+        vector<Edge> edges;
+        if(c.graph == "erdos") edges = gen_erdos(c.n, 10.0 / c.n, rng);
+        else if(c.graph == "clique") edges = gen_clique(c.n, 5, rng);
+        else if(c.graph == "sbm") edges = gen_sbm({c.n / 2, c.n - c.n / 2}, 20.0 / c.n, 0.5 / c.n, rng);
+        else edges = gen_power_law(c.n, 2.5, 8.0, rng);
+
+        auto t0 = chrono::high_resolution_clock::now();
+        int raw = stoer_wagner_auto(c.n, edges);
+        auto t1 = chrono::high_resolution_clock::now();
+        Kernel K = kernelize(build_csr(c.n, edges));
         auto t2 = chrono::high_resolution_clock::now();
-        int c2 = karger_stein(n, edges, local);
+        long long cut = K.upper;
+        if(K.g.n > 1) cut = min(cut, stoer_wagner_csr(K.g));
         auto t3 = chrono::high_resolution_clock::now();
-        double ms2 = chrono::duration<double,milli>(t3-t2).count();
-
-        if(isErdos){
-            ned++;
-            ke_time += ms1;
-            kse_time += ms2;
-            if(c1 == true_cut) ke++;
-            if(c2 == true_cut) kse++;
-        } else {
-            ncl++;
-            kc_time += ms1;
-            ksc_time += ms2;
-            if(c1 == true_cut) kc++;
-            if(c2 == true_cut) ksc++;
-        }
+
+        double raw_ms = chrono::duration<double,milli>(t1-t0).count();
+        double kernel_ms = chrono::duration<double,milli>(t2-t1).count();
+        double solve_ms = chrono::duration<double,milli>(t3-t2).count();
+
+        cout << c.graph << " n=" << c.n << " m=" << edges.size()
+             << " kernel n=" << K.stats.n << " m=" << K.stats.m
+             << " raw=" << raw_ms << "ms kernel=" << kernel_ms << "ms solve=" << solve_ms << "ms"
+             << " cut=" << cut << (cut == raw ? "" : "  CUT MISMATCH") << "\n";
+
+        fout << c.graph << "," << c.n << "," << edges.size() << ","
+             << K.stats.n << "," << K.stats.m << ","
+             << raw_ms << "," << kernel_ms << "," << solve_ms << ","
+             << cut << "," << (cut == raw) << "\n";
     }
 
-    Summary S;
+    fout.close();
+    cout << "Saved: " << out << "\n";
+}
 
-    S.erdos_k_acc  = ned ? (double)ke / ned : 0;
-    S.erdos_ks_acc = ned ? (double)kse / ned : 0;
-    S.clique_k_acc = ncl ? (double)kc / ncl : 0;
-    S.clique_ks_acc= ncl ? (double)ksc / ncl : 0;
+// ------------------------------------------------------------
+// Tree packing vs Stoer–Wagner (--bench-treepack)
+// Tree-packing cuts (mincut_treepack.h, exact w.h.p.) checked against
+// exact stoer_wagner_csr; SW is skipped (sw_ms empty) above 5000 vertices
+// where it takes minutes.
+// Graphs have mean degree 16 so they are connected; the sbm halves share
+// only a few edges, a cut well below the minimum degree. Weighted rows
+// give each edge a weight in 1..9, which leaves no useful lower bound, so
+// every sampled tree is searched.
+// ------------------------------------------------------------
+void bench_treepack(const string &out){
+    ofstream fout(out);
+    fout << "graph,n,m,weighted,p,packed,trees,found_at,tp_ms,sw_ms,cut,cuts_match\n";
+
+    struct Config { string graph; int n; bool weighted; };
+    vector<Config> configs = {
+        {"erdos", 5000, false}, {"erdos", 5000, true}, {"sbm", 5000, false}, {"sbm", 5000, true},
+        {"erdos", 20000, true}, {"sbm", 20000, true}, {"erdos", 100000, true}
+    };
+
+    for(const auto &c : configs){
+        mt19937 rng(42 + c.n);
+        vector<Edge> edges;
+        if(c.graph == "erdos") edges = gen_erdos(c.n, 16.0 / c.n, rng);
+        else edges = gen_sbm({c.n / 2, c.n - c.n / 2}, 32.0 / c.n, 16.0 / ((double)c.n * c.n), rng);
+        vector<int> w(edges.size(), 1);
+        if(c.weighted) for(auto &x : w) x = 1 + rng() % 9;
+        CsrGraph g = build_csr(c.n, edges.size(), [&](size_t i, int &u, int &v, int &wt){
+            u = edges[i].first; v = edges[i].second; wt = w[i];
+        });
+
+        auto t0 = chrono::high_resolution_clock::now();
+        TreePackResult R = treepack_mincut(g, 0, 7);
+        auto t1 = chrono::high_resolution_clock::now();
+        bool run_sw = c.n <= 5000;
+        long long sw = run_sw ? stoer_wagner_csr(g) : -1;
+        auto t2 = chrono::high_resolution_clock::now();
 
-    S.combined_k_acc  = (double)(ke + kc)  / trials;
-    S.combined_ks_acc = (double)(kse + ksc)/ trials;
+        double tp_ms = chrono::duration<double,milli>(t1-t0).count();
+        double sw_ms = chrono::duration<double,milli>(t2-t1).count();
+
+        cout << c.graph << (c.weighted ? " weighted" : "") << " n=" << c.n << " m=" << g.edges()
+             << " p=" << R.p << " packed=" << R.packed << " trees=" << R.trees
+             << " found_at=" << R.found_at << " tp=" << tp_ms << "ms";
+        if(run_sw) cout << " sw=" << sw_ms << "ms";
+        cout << " cut=" << R.cut << (run_sw && R.cut != sw ? "  CUT MISMATCH" : "") << "\n";
+
+        fout << c.graph << "," << c.n << "," << g.edges() << "," << c.weighted << ","
+             << R.p << "," << R.packed << "," << R.trees << "," << R.found_at << "," << tp_ms << ",";
+        if(run_sw) fout << sw_ms;
+        fout << "," << R.cut << ",";
+        if(run_sw) fout << (R.cut == sw);
+        fout << "\n";
+    }
 
-    S.erdos_k_ms  = ned ? ke_time / ned : 0;
-    S.erdos_ks_ms = ned ? kse_time / ned : 0;
-    S.clique_k_ms = ncl ? kc_time / ncl : 0;
-    S.clique_ks_ms= ncl ? ksc_time / ncl : 0;
+    fout.close();
+    cout << "Saved: " << out << "\n";
+}
 
-    return S;
+// ------------------------------------------------------------
+// Heap allocation counter (read by --bench-ks-alloc)
+// Only built with -DMINCUT_ALLOC_COUNT (or MINCUT_STATS, for bytes_alloc),
+// so normal builds keep the library operator new.
+// ------------------------------------------------------------
+#if defined(MINCUT_ALLOC_COUNT) || defined(MINCUT_STATS)
+#define MINCUT_HOOK_NEW 1
+#endif
+
+static atomic<unsigned long long> g_allocs{0};
+
+#ifdef MINCUT_HOOK_NEW
+constexpr bool alloc_counting = true;
+
+// noinline keeps GCC from pairing the inlined free() with std's operator new
+__attribute__((noinline)) void* operator new(size_t sz){
+    g_allocs.fetch_add(1, memory_order_relaxed);
+    MINCUT_COUNT(bytes_alloc, sz);
+    if(void *p = malloc(sz ? sz : 1)) return p;
+    throw bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void *p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept { free(p); }
+#else
+constexpr bool alloc_counting = false;
+#endif
+
+// ------------------------------------------------------------
+// Karger–Stein allocation benchmark: the heap-allocating recursion
+// (karger_stein_rec) vs the arena recursion (karger_stein). Both must
+// return the same cut for the same seed. Without -DMINCUT_ALLOC_COUNT the
+// allocation columns are -1.
+// ------------------------------------------------------------
+void bench_ks_alloc(const string &out){
+    if(!alloc_counting)
+        cerr << "note: built without -DMINCUT_ALLOC_COUNT, allocations are not counted\n";
+    ofstream fout(out);
+    fout << "graph,n,m,old_allocs,new_allocs,old_ms,new_ms,speedup,cuts_match\n";
+
+    const int REPS = 5;
+    vector<pair<string,int>> configs = {
+        {"erdos", 25}, {"erdos", 50}, {"erdos", 100}, {"erdos", 150},
+        {"clique", 25}, {"clique", 50}, {"clique", 100}, {"clique", 150}
+    };
+
+    // Warm the arena so its one-time block allocation isn't charged to a row
+    { mt19937 w(1); auto e = gen_clique(150, 5, w); karger_stein(150, e, w); }
+
+    for(auto &[graph, n] : configs){
+        mt19937 rng(99 + n);
+        vector<Edge> edges = (graph == "erdos")
+            ? gen_erdos(n, 0.1, rng)
+            : gen_clique(n, 5, rng);
+
+        unsigned long long old_allocs = 0, new_allocs = 0;
+        double old_ms = 0, new_ms = 0;
+        bool match = true;
+
+        for(int r=0;r<REPS;r++){
+            mt19937 a(r), b(r);
+
+            unsigned long long c0 = g_allocs;
+            auto t0 = chrono::high_resolution_clock::now();
+            int c_old = karger_stein_rec(n, edges, a);
+            auto t1 = chrono::high_resolution_clock::now();
+            unsigned long long c1 = g_allocs;
+            int c_new = karger_stein(n, edges, b);
+            auto t2 = chrono::high_resolution_clock::now();
+            unsigned long long c2 = g_allocs;
+
+            old_allocs += c1 - c0;
+            new_allocs += c2 - c1;
+            old_ms += chrono::duration<double,milli>(t1-t0).count();
+            new_ms += chrono::duration<double,milli>(t2-t1).count();
+            match = match && (c_old == c_new);
+        }
+
+        long long old_avg = alloc_counting ? (long long)(old_allocs / REPS) : -1;
+        long long new_avg = alloc_counting ? (long long)(new_allocs / REPS) : -1;
+        cout << graph << " n=" << n
+             << " allocs " << old_avg << " -> " << new_avg
+             << " ms " << old_ms / REPS << " -> " << new_ms / REPS
+             << (match ? "" : "  CUT MISMATCH") << "\n";
+
+        fout << graph << "," << n << "," << edges.size() << ","
+             << old_avg << "," << new_avg << ","
+             << old_ms / REPS << "," << new_ms / REPS << ","
+             << old_ms / new_ms << "," << match << "\n";
+    }
+
+    fout.close();
+    cout << "Saved: " << out << "\n";
 }
 
 // ------------------------------------------------------------
 // MAIN — Batch Runner
 // ------------------------------------------------------------
 int main(int argc, char** argv){
-    if(argc != 2){
-        cerr << "Usage: ./karger_batch_ks output.csv\n";
+    if(argc >= 4 && argc <= 6 && (string(argv[1]) == "--mincut" || string(argv[1]) == "--mincut-kernel")){
+        int trials = (argc >= 5) ? stoi(argv[4]) : 1;
+        uint32_t seed = (argc >= 6) ? (uint32_t)stoul(argv[5]) : random_device{}();
+        return file_mincut(argv[2], argv[3], trials, seed, string(argv[1]) == "--mincut-kernel");
+    }
+    if(argc >= 5 && argc <= 7 && string(argv[1]) == "--mincut-delta"){
+        uint32_t seed = (argc >= 6) ? (uint32_t)stoul(argv[5]) : random_device{}();
+        long long cap = (argc >= 7) ? stoll(argv[6]) : LLONG_MAX;
+        return file_mincut_delta(argv[2], argv[3], stod(argv[4]), seed, cap);
+    }
+    if(argc == 3 && string(argv[1]) == "--check-load")
+        return check_load(argv[2]);
+    if(argc == 4 && string(argv[1]) == "--to-csr"){
+        GraphData g;
+        if(!load_graph(argv[2], g) || !save_csr(argv[3], g)) return 1;
+        cout << "Wrote " << argv[3] << " (n=" << g.n << ", edges=" << g.edges.size() << ")\n";
+        return 0;
+    }
+    if(argc == 3 && string(argv[1]) == "--bench-contract"){
+        bench_contract(argv[2]);
+        return 0;
+    }
+    if(argc == 3 && string(argv[1]) == "--bench-ks-alloc"){
+        bench_ks_alloc(argv[2]);
+        return 0;
+    }
+    if(argc == 3 && string(argv[1]) == "--bench-weighted"){
+        bench_weighted(argv[2]);
+        return 0;
+    }
+    if(argc == 3 && string(argv[1]) == "--bench-gen"){
+        bench_gen(argv[2]);
+        return 0;
+    }
+    if(argc == 3 && string(argv[1]) == "--bench-kernel"){
+        bench_kernel(argv[2]);
+        return 0;
+    }
+    if(argc == 3 && string(argv[1]) == "--bench-treepack"){
+        bench_treepack(argv[2]);
+        return 0;
+    }
+    if(argc == 3 && string(argv[1]) == "--bench-sw"){
+        bench_sw(argv[2]);
+        return 0;
+    }
+    if(argc == 3 && string(argv[1]) == "--bench-ks-par"){
+        bench_ks_par(argv[2]);
+        return 0;
+    }
+
+    if(argc != 2 && !(argc == 4 && string(argv[2]) == "--threads")){
+        cerr << "Usage: ./karger_batch_ks output.{csv,col} [--threads T]\n"
+             << "       ./karger_batch_ks --bench-contract bench.csv\n"
+             << "       ./karger_batch_ks --bench-ks-par bench.csv\n"
+             << "       ./karger_batch_ks --bench-ks-alloc bench.csv   (allocation counts need -DMINCUT_ALLOC_COUNT)\n"
+             << "       ./karger_batch_ks --bench-sw bench.csv\n"
+             << "       ./karger_batch_ks --bench-weighted bench.csv\n"
+             << "       ./karger_batch_ks --bench-gen bench.csv\n"
+             << "       ./karger_batch_ks --bench-kernel bench.csv\n"
+             << "       ./karger_batch_ks --bench-treepack bench.csv\n"
+             << "       ./karger_batch_ks --mincut graph.{txt,graph,csr} karger|ks|sw|tp [trials] [seed]\n"
+             << "       ./karger_batch_ks --mincut-kernel graph karger|ks|sw|tp [trials] [seed]\n"
+             << "       ./karger_batch_ks --mincut-delta graph karger|ks delta [seed] [max_trials]\n"
+             << "       ./karger_batch_ks --to-csr graph.{txt,graph} out.csr\n"
+             << "       ./karger_batch_ks --check-load scratch_prefix\n";
         return 1;
     }
 
     string out = argv[1];
-    ofstream fout(out);
 
-    fout
-    << "n,trials,"
-    << "erdos_k_acc,clique_k_acc,combined_k_acc,"
-    << "erdos_ks_acc,clique_ks_acc,combined_ks_acc,"
-    << "erdos_k_ms,clique_k_ms,"
-    << "erdos_ks_ms,clique_ks_ms,"
-    << "seed\n";
+    // Trials are spread over all cores unless told otherwise
+    int threads = (argc == 4) ? stoi(argv[3]) : (int)max(1u, thread::hardware_concurrency());
+
+    // CSV, or the typed column file for a .col path (../common/result_sink.h)
+    vector<string> columns = {
+        "n", "trials",
+        "erdos_k_acc", "clique_k_acc", "combined_k_acc",
+        "erdos_ks_acc", "clique_ks_acc", "combined_ks_acc",
+        "erdos_k_ms", "clique_k_ms",
+        "erdos_ks_ms", "clique_ks_ms",
+        "seed"};
+    for(const char *prefix : {"setup_", "karger_", "ks_"})
+        for(const string &c : mincut_stats_columns(prefix)) columns.push_back(c);
+    // The stats columns are per-trial averages of ns and byte counts, far
+    // past the default 6 significant digits
+    ResultSink fout(out, columns, mincut_stats_enabled ? 15 : 6);
 
     vector<int> Ns = {10, 20, 50, 75, 100, 150};
     vector<int> Trials = {100, 1000, 5000, 10000, 20000};
@@ -360,23 +1219,29 @@ int main(int argc, char** argv){
 
             cout << "Running n=" << n
                  << " trials=" << T
-                 << " seed=" << seed << "...\n";
-
-            Summary S = run_experiment(n, T, k, p, seed);
-
-            fout
-            << n << "," << T << ","
-            << S.erdos_k_acc << ","
-            << S.clique_k_acc << ","
-            << S.combined_k_acc << ","
-            << S.erdos_ks_acc << ","
-            << S.clique_ks_acc << ","
-            << S.combined_ks_acc << ","
-            << S.erdos_k_ms << ","
-            << S.clique_k_ms << ","
-            << S.erdos_ks_ms << ","
-            << S.clique_ks_ms << ","
-            << seed << "\n";
+                 << " seed=" << seed
+                 << " threads=" << threads << "...\n";
+
+            Summary S = run_experiment(n, T, k, p, seed, threads);
+
+            auto row = fout.row();
+            row
+            << n << T
+            << S.erdos_k_acc
+            << S.clique_k_acc
+            << S.combined_k_acc
+            << S.erdos_ks_acc
+            << S.clique_ks_acc
+            << S.combined_ks_acc
+            << S.erdos_k_ms
+            << S.clique_k_ms
+            << S.erdos_ks_ms
+            << S.clique_ks_ms
+            << seed;
+            // Per-trial averages
+            mincut_stats_row(row, S.setup, T);
+            mincut_stats_row(row, S.karger, T);
+            mincut_stats_row(row, S.ks, T);
         }
     }
 
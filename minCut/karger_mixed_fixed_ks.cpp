@@ -1,134 +1,34 @@
 // karger_mixed_fixed_ks.cpp
 // Mixed graph experiment: Erdős & Clique
 // Includes: Karger (single-run), Karger–Stein (recursive), and Stoer-Wagner (exact)
+// Build with -DMINCUT_STATS to append per-phase timers and counters to each trial row.
 
 #include <bits/stdc++.h>
+#include "graph_io.h"
+#include "csr_graph.h"
+#include "graph_gen.h"
+#include "mincut_budget.h"
+#include "mincut_file.h"
+#include "mincut_kernel.h"
+#include "mincut_stats.h"
+#include "../common/result_sink.h"
+#include "mincut_treepack.h"
+#include "sw_dense.h"
 using namespace std;
 using Edge = pair<int,int>;
 
 // ------------------------------------------------------------
-// DSU
+// Karger (single run) — CSR engine, see csr_graph.h
 // ------------------------------------------------------------
-struct DSU {
-    vector<int> p, r;
-    int comp;
-    DSU(int n=0){ init(n); }
-    void init(int n){
-        p.resize(n);
-        r.assign(n,0);
-        iota(p.begin(), p.end(), 0);
-        comp = n;
-    }
-    int find(int x){ return p[x]==x ? x : p[x] = find(p[x]); }
-    bool unite(int a,int b){
-        a = find(a); b = find(b);
-        if(a==b) return false;
-        if(r[a] < r[b]) swap(a,b);
-        p[b] = a;
-        if(r[a]==r[b]) r[a]++;
-        comp--;
-        return true;
-    }
-};
-
-// ------------------------------------------------------------
-// Karger (single run)
-// ------------------------------------------------------------
-int karger_once(int n, const vector<Edge>& original_edges, mt19937 &rng){
-    vector<Edge> edges = original_edges;
-    DSU dsu(n);
-
-    while(dsu.comp > 2 && !edges.empty()){
-        uniform_int_distribution<size_t> dist(0, edges.size()-1);
-        size_t idx = dist(rng);
-
-        int u = edges[idx].first;
-        int v = edges[idx].second;
-        int ru = dsu.find(u), rv = dsu.find(v);
-
-        if(ru == rv){
-            edges[idx] = edges.back();
-            edges.pop_back();
-            continue;
-        }
-
-        dsu.unite(ru, rv);
-
-        vector<Edge> new_edges;
-        new_edges.reserve(edges.size());
-        for(const auto &e : edges){
-            int a = dsu.find(e.first);
-            int b = dsu.find(e.second);
-            if(a != b) new_edges.emplace_back(a,b);
-        }
-        edges.swap(new_edges);
-    }
-
-    int cut = 0;
-    for(const auto &e : original_edges){
-        if(dsu.find(e.first) != dsu.find(e.second)) cut++;
-    }
-    return cut;
+int karger_once(int n, const vector<Edge>& edges, mt19937 &rng){
+    return (int)karger_once_csr(build_csr(n, edges), rng);
 }
 
 // ------------------------------------------------------------
-// Stoer–Wagner (warning-free)
+// Stoer–Wagner — CSR + indexed heap, O(n + m) memory
 // ------------------------------------------------------------
 int stoer_wagner(int N, const vector<Edge>& edges){
-    if(N <= 1) return 0;
-
-    vector<vector<int>> w(N, vector<int>(N, 0));
-    for(const auto &e : edges){
-        w[e.first][e.second]++;
-        w[e.second][e.first]++;
-    }
-
-    vector<int> v(N);
-    iota(v.begin(), v.end(), 0);
-
-    int best = INT_MAX;
-    int n = N;
-
-    while(n > 1){
-        vector<int> added(n, 0), weights(n, 0);
-        int prev = -1, last = -1;
-
-        for(int i=0;i<n;i++){
-            int sel = -1;
-            for(int j=0;j<n;j++)
-                if(!added[j] && (sel == -1 || weights[j] > weights[sel]))
-                    sel = j;
-
-            added[sel] = 1;
-            prev = last;
-            last = sel;
-
-            if(i == n-1) break;
-
-            for(int j=0;j<n;j++)
-                if(!added[j])
-                    weights[j] += w[v[sel]][v[j]];
-        }
-
-        int cut = 0;
-        for(int j=0;j<n;j++)
-            if(j != last) cut += w[v[last]][v[j]];
-        best = min(best, cut);
-
-        if(prev < 0) break;
-
-        int s = v[prev], t = v[last];
-        for(int j=0;j<n;j++){
-            int node = v[j];
-            w[s][node] += w[t][node];
-            w[node][s] = w[s][node];
-        }
-
-        v[last] = v[n-1];
-        n--;
-    }
-
-    return best;
+    return (int)stoer_wagner_csr(build_csr(N, edges));
 }
 
 // ------------------------------------------------------------
@@ -138,58 +38,31 @@ pair<int, vector<Edge>>
 contract_until(int n, const vector<Edge>& original, int target, mt19937 &rng){
     if(target >= n) return {n, original};
 
-    vector<Edge> edges = original;
-    DSU dsu(n);
-
-    while(dsu.comp > target){
-        uniform_int_distribution<size_t> dist(0, edges.size()-1);
-        size_t idx = dist(rng);
-
-        int u = edges[idx].first;
-        int v = edges[idx].second;
-
-        int ru = dsu.find(u), rv = dsu.find(v);
-        if(ru == rv){
-            edges[idx] = edges.back();
-            edges.pop_back();
-            continue;
-        }
-
-        dsu.unite(ru, rv);
-
-        vector<Edge> filtered;
-        filtered.reserve(edges.size());
-        for(const auto &e : edges){
-            int a = dsu.find(e.first);
-            int b = dsu.find(e.second);
-            if(a != b) filtered.emplace_back(a,b);
-        }
-        edges.swap(filtered);
-    }
-
-    unordered_map<int,int> mp;
-    int newn = 0;
-    for(int i=0;i<n;i++){
-        int r = dsu.find(i);
-        if(!mp.count(r)) mp[r] = newn++;
-    }
+    CsrGraph g = contract_until_csr(build_csr(n, original), target, rng);
 
+    // Back to a multigraph: an entry of weight w is w parallel edges
+    MINCUT_PHASE(MP_COPY);
     vector<Edge> new_edges;
-    for(const auto &e : edges){
-        int a = mp[ dsu.find(e.first) ];
-        int b = mp[ dsu.find(e.second) ];
-        if(a != b) new_edges.emplace_back(a,b);
-    }
+    new_edges.reserve(original.size());
+    for(int u=0;u<g.n;u++)
+        for(uint64_t i=g.off[u];i<g.off[u+1];i++)
+            if((int)g.adj[i] > u)
+                for(uint32_t c=0;c<g.w[i];c++) new_edges.emplace_back(u, g.adj[i]);
 
-    return {newn, new_edges};
+    return {g.n, new_edges};
 }
 
 // ------------------------------------------------------------
 // Karger–Stein recursive
+// The base case runs the flat dense Stoer–Wagner (sw_dense.h): at n <= 6
+// a CSR build would cost more than the whole cut.
 // ------------------------------------------------------------
 int karger_stein_rec(int n, const vector<Edge>& edges, mt19937 &rng){
+    MINCUT_COUNT(rec_nodes, 1);
     if(n <= 6)
-        return stoer_wagner(n, edges);
+        return stoer_wagner_flat(n, edges.size(), [&](size_t i, int &u, int &v, int &w){
+            u = edges[i].first; v = edges[i].second; w = 1;
+        });
 
     int t = (int)ceil(n / sqrt(2.0));
 
@@ -200,6 +73,9 @@ int karger_stein_rec(int n, const vector<Edge>& edges, mt19937 &rng){
     auto [n1, e1] = contract_until(n, edges, t, rng1);
     auto [n2, e2] = contract_until(n, edges, t, rng2);
 
+    // Contraction ran out of edges above t: the graph is disconnected
+    if(n1 > t || n2 > t) return 0;
+
     int c1 = karger_stein_rec(n1, e1, rng1);
     int c2 = karger_stein_rec(n2, e2, rng2);
 
@@ -213,15 +89,9 @@ int karger_stein(int n, const vector<Edge>& edges, mt19937 &rng){
 // ------------------------------------------------------------
 // Graph Generators
 // ------------------------------------------------------------
+// Geometric skipping (graph_gen.h): O(n + m) instead of one draw per pair
 vector<Edge> gen_erdos(int n, double p, mt19937 &rng){
-    vector<Edge> edges;
-    uniform_real_distribution<double> ud(0, 1);
-
-    for(int i=0;i<n;i++)
-        for(int j=i+1;j<n;j++)
-            if(ud(rng) < p) edges.emplace_back(i,j);
-
-    return edges;
+    return gen_erdos_skip(n, p, rng);
 }
 
 vector<Edge> gen_clique(int n, int k, mt19937 &rng){
@@ -245,12 +115,40 @@ vector<Edge> gen_clique(int n, int k, mt19937 &rng){
     return edges;
 }
 
+#ifdef MINCUT_STATS
+// Counts bytes_alloc; noinline for the same reason as in karger_batch_ks.cpp
+__attribute__((noinline)) void* operator new(size_t sz){
+    MINCUT_COUNT(bytes_alloc, sz);
+    if(void *p = malloc(sz ? sz : 1)) return p;
+    throw bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void *p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept { free(p); }
+#endif
+
 // ------------------------------------------------------------
 // MAIN — Mixed Experiments
 // ------------------------------------------------------------
 int main(int argc, char** argv){
+    if(argc >= 4 && argc <= 6 && (string(argv[1]) == "--mincut" || string(argv[1]) == "--mincut-kernel")){
+        int trials = (argc >= 5) ? stoi(argv[4]) : 1;
+        uint32_t seed = (argc >= 6) ? (uint32_t)stoul(argv[5]) : random_device{}();
+        return file_mincut(argv[2], argv[3], trials, seed, string(argv[1]) == "--mincut-kernel");
+    }
+    if(argc >= 5 && argc <= 7 && string(argv[1]) == "--mincut-delta"){
+        uint32_t seed = (argc >= 6) ? (uint32_t)stoul(argv[5]) : random_device{}();
+        long long cap = (argc >= 7) ? stoll(argv[6]) : LLONG_MAX;
+        return file_mincut_delta(argv[2], argv[3], stod(argv[4]), seed, cap);
+    }
+    if(argc == 3 && string(argv[1]) == "--check-load")
+        return check_load(argv[2]);
+
     if(argc != 7){
-        cerr << "Usage: ./karger_mixed_fixed_ks n p k trials seed out.csv\n";
+        cerr << "Usage: ./karger_mixed_fixed_ks n p k trials seed out.{csv,col}\n"
+             << "       ./karger_mixed_fixed_ks --mincut graph.{txt,graph,csr} karger|ks|sw|tp [trials] [seed]\n"
+             << "       ./karger_mixed_fixed_ks --mincut-kernel graph karger|ks|sw|tp [trials] [seed]\n"
+             << "       ./karger_mixed_fixed_ks --mincut-delta graph karger|ks delta [seed] [max_trials]\n"
+             << "       ./karger_mixed_fixed_ks --check-load scratch_prefix\n";
         return 1;
     }
 
@@ -261,10 +159,14 @@ int main(int argc, char** argv){
     unsigned long long seed = stoull(argv[5]);
     string out = argv[6];
 
-    ofstream fout(out);
-    fout << "trial_id,graph_type,true_mincut,"
-            "karger_cut,karger_ms,karger_correct,"
-            "ks_cut,ks_ms,ks_correct\n";
+    // CSV, or the typed column file for a .col path (../common/result_sink.h)
+    vector<string> columns = {
+        "trial_id", "graph_type", "true_mincut",
+        "karger_cut", "karger_ms", "karger_correct",
+        "ks_cut", "ks_ms", "ks_correct"};
+    for(const char *prefix : {"setup_", "karger_", "ks_"})
+        for(const string &c : mincut_stats_columns(prefix)) columns.push_back(c);
+    ResultSink fout(out, columns);
 
     mt19937 exp_rng(seed);
 
@@ -278,12 +180,17 @@ int main(int argc, char** argv){
     for(int t=1;t<=trials;t++){
         uint32_t run_seed = exp_rng();
         mt19937 local(run_seed);
+        mincut_stats_take();
 
         bool is_erdos = (local() & 1);
-        vector<Edge> edges = is_erdos ?
-            gen_erdos(n, p, local) : gen_clique(n, k, local);
+        vector<Edge> edges;
+        {
+            MINCUT_PHASE(MP_GEN);
+            edges = is_erdos ? gen_erdos(n, p, local) : gen_clique(n, k, local);
+        }
 
         int true_cut = stoer_wagner(n, edges);
+        MincutStats setup_st = mincut_stats_take();
 
         // KARGER
         auto t0 = chrono::high_resolution_clock::now();
@@ -291,6 +198,7 @@ int main(int argc, char** argv){
         auto t1 = chrono::high_resolution_clock::now();
         double k_ms = chrono::duration<double,milli>(t1-t0).count();
         bool kc_ok = (kc == true_cut);
+        MincutStats karger_st = mincut_stats_take();
 
         // KARGER-STEIN
         auto s0 = chrono::high_resolution_clock::now();
@@ -298,12 +206,19 @@ int main(int argc, char** argv){
         auto s1 = chrono::high_resolution_clock::now();
         double ks_ms = chrono::duration<double,milli>(s1-s0).count();
         bool ks_ok = (ks == true_cut);
+        MincutStats ks_st = mincut_stats_take();
 
         // logging
-        fout << t << "," << (is_erdos?"erdos":"clique") << ","
-             << true_cut << ","
-             << kc << "," << k_ms << "," << kc_ok << ","
-             << ks << "," << ks_ms << "," << ks_ok << "\n";
+        {
+            auto row = fout.row();
+            row << t << (is_erdos?"erdos":"clique")
+                << true_cut
+                << kc << k_ms << kc_ok
+                << ks << ks_ms << ks_ok;
+            mincut_stats_row(row, setup_st);
+            mincut_stats_row(row, karger_st);
+            mincut_stats_row(row, ks_st);
+        }
 
         // stats
         if(is_erdos){
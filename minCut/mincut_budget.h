@@ -0,0 +1,128 @@
+// mincut_budget.h
+// Trial budgeting for the randomized min-cut engines.
+//
+// A Karger run finds a fixed min cut with probability at least
+// C(2,2)/C(n,2) = 2/(n(n-1)); a Karger–Stein run, with contraction to
+// ceil(n/√2) and an exact base case, satisfies
+//     P(n) >= 1 - (1 - q(n)·P(t))²,   q(n) = t(t-1) / (n(n-1)).
+// T independent runs all miss with probability at most (1-p)^T, so
+// T = ceil(ln δ / ln(1-p)) runs reach failure probability δ.
+//
+// Runs stop before the budget once the best cut meets a proven lower
+// bound, and the search starts from the minimum weighted degree, which is
+// always a valid cut.
+
+#ifndef MINCUT_BUDGET_H
+#define MINCUT_BUDGET_H
+
+#include "csr_graph.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+
+// Lower bound on one Karger run's success probability
+inline double karger_success_bound(int n){
+    if(n <= 2) return 1.0;
+    return 2.0 / ((double)n * (n - 1));
+}
+
+// Lower bound on one Karger–Stein run's success probability; runs at or
+// below 'base' vertices are exact
+inline double karger_stein_success_bound(int n, int base){
+    if(n <= base || n <= 2) return 1.0;
+    int t = (int)std::ceil(n / std::sqrt(2.0));
+    double q = ((double)t * (t - 1)) / ((double)n * (n - 1));
+    double miss = 1.0 - q * karger_stein_success_bound(t, base);
+    return 1.0 - miss * miss;
+}
+
+// Runs needed so that all of them miss with probability <= delta
+inline long long trials_for_delta(double p, double delta){
+    if(p >= 1.0) return 1;
+    double t = std::ceil(std::log(delta) / std::log1p(-p));
+    return t >= 9e18 ? LLONG_MAX : std::max(1LL, (long long)t);
+}
+
+// Failure probability actually reached after 'trials' runs
+inline double delta_after(double p, long long trials){
+    if(p >= 1.0) return 0.0;
+    return std::exp((double)trials * std::log1p(-p));
+}
+
+// Minimum weighted degree: the trivial cut around one vertex
+inline long long min_weighted_degree(const CsrGraph& g){
+    long long best = LLONG_MAX;
+    for(int u=0;u<g.n;u++){
+        long long d = 0;
+        for(uint64_t i=g.off[u];i<g.off[u + 1];i++) d += g.w[i];
+        best = std::min(best, d);
+    }
+    return g.n ? best : 0;
+}
+
+// Proven lower bound on the min cut:
+//   disconnected           0
+//   connected              smallest edge weight
+//   simple (all w = 1)     min(δ, h(δ - h + 1)), h = floor(n/2): a side of
+//                          s <= n/2 vertices has >= s(δ - s + 1) edges
+//                          leaving it, and that is concave in s
+inline long long mincut_lower_bound(const CsrGraph& g){
+    if(g.n <= 1) return 0;
+
+    CsrUnionFind uf(g.n);
+    uint32_t min_w = UINT32_MAX, max_w = 0;
+    for(int u=0;u<g.n;u++)
+        for(uint64_t i=g.off[u];i<g.off[u + 1];i++){
+            uf.unite(u, g.adj[i]);
+            min_w = std::min(min_w, g.w[i]);
+            max_w = std::max(max_w, g.w[i]);
+        }
+    if(uf.comp > 1) return 0;
+
+    long long lb = min_w;
+    if(max_w == 1){
+        long long d = min_weighted_degree(g), h = g.n / 2;
+        lb = std::max(lb, std::min(d, h * (d - h + 1)));
+    }
+    return lb;
+}
+
+struct BudgetResult {
+    long long cut = 0;
+    long long lower = 0;
+    long long budget = 0;      // runs needed for delta
+    long long trials = 0;      // runs actually made
+    double delta = 1.0;        // failure bound reached
+    bool early = false;        // stopped at the lower bound
+    double ms = 0;
+};
+
+// Repeats trial() until the budget for delta (capped at max_trials) is
+// spent or the best cut reaches the lower bound
+template<class Trial>
+BudgetResult run_until_confident(const CsrGraph& g, double p, double delta,
+                                 long long max_trials, Trial trial){
+    auto t0 = std::chrono::high_resolution_clock::now();
+    BudgetResult r;
+    r.lower = mincut_lower_bound(g);
+    // A lower bound of 0 means the graph is disconnected: the cut between
+    // components is 0 and no run is needed (contraction would stall there)
+    r.cut = r.lower == 0 ? 0 : min_weighted_degree(g);
+    r.budget = trials_for_delta(p, delta);
+
+    long long limit = std::min(r.budget, max_trials);
+    while(r.cut > r.lower && r.trials < limit){
+        r.cut = std::min(r.cut, trial());
+        r.trials++;
+    }
+    r.early = r.cut <= r.lower;
+    r.delta = r.early ? 0.0 : delta_after(p, r.trials);
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    r.ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    return r;
+}
+
+#endif
@@ -0,0 +1,259 @@
+// mincut_file.h
+// Min cut of a graph file: the --mincut, --mincut-kernel and
+// --mincut-delta modes, plus the --check-load loader check, shared by
+// karger_batch_ks and karger_mixed_fixed_ks.
+//
+// Inputs go through load_graph (graph_io.h) straight into a CsrGraph,
+// which folds parallel edges into weights; a .csr file is read from its
+// mapping with no intermediate edge list. Every engine then works on the
+// unique weighted pairs, so an edge of weight 10^9 costs the same as an
+// edge of weight 1.
+
+#ifndef MINCUT_FILE_H
+#define MINCUT_FILE_H
+
+#include "csr_graph.h"
+#include "graph_io.h"
+#include "mincut_budget.h"
+#include "mincut_kernel.h"
+#include "mincut_treepack.h"
+#include "mincut_weighted.h"
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Loads 'path' into a CsrGraph with n >= 1. Folded weights are uint32 and
+// the weighted engines keep them as int, so a total weight above INT_MAX
+// is rejected here rather than wrapped.
+inline bool load_mincut_graph(const std::string &path, CsrGraph &g){
+    if(!load_graph(path, g)) return false;
+    long long total = 0;
+    for(uint32_t w : g.w) total += w;
+    total /= 2;
+    if(total > INT_MAX){
+        std::cerr << "Total edge weight " << total << " above " << INT_MAX << "\n";
+        return false;
+    }
+    if(g.n < 1){
+        g = CsrGraph();
+        g.n = 1;
+        g.off.assign(2, 0);
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Min cut of a graph file (--mincut)
+// Runs one engine: karger (karger_once_csr) and ks
+// (karger_stein_weighted) keep the best of 'trials' runs, sw is exact
+// (stoer_wagner_auto), tp is tree packing (mincut_treepack.h), exact
+// w.h.p. with its default tree count. With 'kernel' the engine runs on the
+// kernel from mincut_kernel.h and the answer is min(kernel upper bound,
+// engine cut).
+// ------------------------------------------------------------
+inline int file_mincut(const std::string &path, const std::string &algo, int trials,
+                       uint32_t seed, bool kernel){
+    using namespace std;
+    if(algo != "karger" && algo != "ks" && algo != "sw" && algo != "tp"){
+        cerr << "Unknown algorithm: " << algo << " (karger|ks|sw|tp)\n";
+        return 1;
+    }
+
+    auto t0 = chrono::high_resolution_clock::now();
+    CsrGraph g;
+    if(!load_mincut_graph(path, g)) return 1;
+    auto t1 = chrono::high_resolution_clock::now();
+
+    long long upper = LLONG_MAX;
+    if(kernel){
+        Kernel K = kernelize(move(g));
+        g = move(K.g);
+        upper = K.upper;
+
+        const KernelStats &st = K.stats;
+        cout << "kernel: n " << st.n0 << " -> " << st.n << ", unique " << st.m0 << " -> " << st.m
+             << " (rounds=" << st.rounds << " leaves=" << st.leaves << " pr13=" << st.pr13
+             << " capforest=" << st.capforest << " pr2=" << st.pr2
+             << " sparsified=" << st.sparsified << ") upper=";
+        if(upper == LLONG_MAX) cout << "none\n";
+        else cout << upper << "\n";
+    }
+    auto tk = chrono::high_resolution_clock::now();
+    int n = g.n;
+
+    // Isolated vertices make the graph disconnected: min cut 0
+    CsrUnionFind uf(n);
+    for(int u=0;u<n;u++)
+        for(uint64_t k=g.off[u];k<g.off[u+1];k++) uf.unite(u, g.adj[k]);
+
+    mt19937 rng(seed);
+    long long best = LLONG_MAX;
+    int hits = 0;
+    if(n <= 1){
+        // No cut to take; a kernel that contracted everything holds the answer
+        best = (upper == LLONG_MAX) ? 0 : upper;
+        hits = trials = 0;
+    } else if(uf.comp > 1){
+        best = 0;
+        hits = trials = 0;
+    } else if(algo == "tp"){
+        TreePackResult R = treepack_mincut(g, 0, seed);
+        best = R.cut;
+        hits = trials = 1;
+        cout << "treepack: p=" << R.p << " rounds=" << R.rounds << " packed=" << R.packed
+             << " searched=" << R.trees << " found_at=" << R.found_at
+             << (R.proven ? " (proven)" : "") << "\n";
+    } else if(algo == "sw"){
+        best = stoer_wagner_auto(n, csr_to_wedges(g));
+        hits = trials = 1;
+    } else if(algo == "karger"){
+        // Trials share one set of edge arrays, as in file_mincut_delta
+        EdgeArrays ea = upper_edges(g);
+        for(int t=0;t<trials;t++){
+            long long c = karger_once_csr(ea, rng);
+            if(c < best){ best = c; hits = 0; }
+            if(c == best) hits++;
+        }
+    } else {
+        vector<WEdge> edges = csr_to_wedges(g);
+        for(int t=0;t<trials;t++){
+            long long c = karger_stein_weighted(n, edges, rng);
+            if(c < best){ best = c; hits = 0; }
+            if(c == best) hits++;
+        }
+    }
+    if(upper < best){ best = upper; hits = 0; }
+    auto t2 = chrono::high_resolution_clock::now();
+
+    cout << "graph=" << path << " n=" << n << " unique=" << g.edges()
+         << " components=" << uf.comp << "\n"
+         << "algo=" << algo << " trials=" << trials << " seed=" << seed
+         << " mincut=" << best << " hits=" << hits << "\n"
+         << "load_ms=" << chrono::duration<double,milli>(t1-t0).count();
+    if(kernel) cout << " kernel_ms=" << chrono::duration<double,milli>(tk-t1).count();
+    cout << " run_ms=" << chrono::duration<double,milli>(t2-tk).count() << "\n";
+    return 0;
+}
+
+// ------------------------------------------------------------
+// Min cut to a target failure probability (--mincut-delta)
+// Loads once, then repeats runs until the δ budget (mincut_budget.h) is
+// spent, max_trials is hit, or the best cut meets the proven lower bound.
+// ------------------------------------------------------------
+inline int file_mincut_delta(const std::string &path, const std::string &algo, double delta,
+                             uint32_t seed, long long max_trials){
+    using namespace std;
+    if(algo != "karger" && algo != "ks"){
+        cerr << "Unknown algorithm: " << algo << " (karger|ks)\n";
+        return 1;
+    }
+    if(!(delta > 0 && delta < 1)){
+        cerr << "delta must be in (0, 1)\n";
+        return 1;
+    }
+
+    auto t0 = chrono::high_resolution_clock::now();
+    CsrGraph g;
+    if(!load_mincut_graph(path, g)) return 1;
+    int n = g.n;
+
+    // Karger runs share the edge arrays, Karger–Stein the weighted pairs
+    EdgeArrays ea;
+    vector<WEdge> edges;
+    if(algo == "karger") ea = upper_edges(g);
+    else edges = csr_to_wedges(g);
+    auto t1 = chrono::high_resolution_clock::now();
+
+    mt19937 rng(seed);
+    BudgetResult r;
+    if(algo == "karger"){
+        r = run_until_confident(g, karger_success_bound(n), delta, max_trials,
+                                [&]{ return karger_once_csr(ea, rng); });
+    } else {
+        r = run_until_confident(g, karger_stein_success_bound(n, 20), delta, max_trials,
+                                [&]{ return karger_stein_weighted(n, edges, rng); });
+    }
+
+    cout << "graph=" << path << " n=" << n << " unique=" << g.edges() << "\n"
+         << "algo=" << algo << " seed=" << seed << " delta=" << delta
+         << " budget=" << r.budget << " trials=" << r.trials
+         << " lower_bound=" << r.lower << " mincut=" << r.cut
+         << (r.early ? " (proven)" : "") << " delta_reached=" << r.delta << "\n"
+         << "prep_ms=" << chrono::duration<double,milli>(t1-t0).count()
+         << " run_ms=" << r.ms << "\n";
+    return 0;
+}
+
+// ------------------------------------------------------------
+// Loader self-check (--check-load)
+// Each weighted edge list goes through load_graph, exact Stoer–Wagner,
+// and a .csr round trip through the direct CsrGraph loader; the second
+// one starts with an unweighted line, which takes an implicit weight of 1.
+// A .csr header whose nnz would wrap the size check must be refused.
+// 'tmp' is a scratch path prefix. Returns the exit status: 0 when every
+// case passes.
+// ------------------------------------------------------------
+inline int check_load(const std::string &tmp){
+    using namespace std;
+    struct Case { const char *text; int n; vector<int> weights; long long cut; };
+    vector<Case> cases = {
+        { "0 1 1000\n1 2 1000\n0 2 1000\n", 3, {1000, 1000, 1000}, 2000 },
+        { "0 1\n1 2 5\n0 2 5\n",            3, {1, 5, 5},          6 },
+    };
+    string txt = tmp + ".txt", csr = tmp + ".csr";
+
+    bool ok = true;
+    for(const auto &c : cases){
+        { ofstream f(txt); f << c.text; }
+        GraphData g;
+        bool loaded = load_graph(txt, g);
+        CsrGraph cg;
+        bool round = loaded && save_csr(csr, g) && load_graph(csr, cg);
+        remove(txt.c_str());
+        remove(csr.c_str());
+
+        long long cut = -1, csr_cut = -1;
+        if(loaded){
+            vector<WEdge> edges;
+            for(size_t i=0;i<g.edges.size();i++)
+                edges.push_back({g.edges[i].first, g.edges[i].second, g.weighted() ? g.weights[i] : 1});
+            cut = stoer_wagner_auto(g.n, merge_parallel(move(edges)));
+        }
+        if(round) csr_cut = stoer_wagner_csr(cg);
+        bool pass = loaded && g.n == c.n && g.weights == c.weights && cut == c.cut
+                 && round && cg.n == c.n && csr_cut == c.cut;
+        cout << "load check: n=" << g.n << " weights=" << g.weights.size()
+             << " cut=" << cut << "/" << c.cut << " csr_cut=" << csr_cut
+             << (pass ? " ok" : "  LOAD MISMATCH") << "\n";
+        ok = ok && pass;
+    }
+
+    {
+        CsrFileHeader h = {};
+        memcpy(h.magic, CSR_MAGIC, sizeof(h.magic));
+        h.version = 1;
+        h.flags = 1;
+        h.n = 3;
+        h.nnz = 1ULL << 62;
+        ofstream f(csr, ios::binary);
+        f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        vector<char> body(64, 0);
+        f.write(body.data(), body.size());
+    }
+    CsrGraph cg;
+    bool refused = !load_graph(csr, cg);
+    remove(csr.c_str());
+    cout << "load check: forged nnz=2^62" << (refused ? " refused ok" : "  ACCEPTED") << "\n";
+    ok = ok && refused;
+
+    return ok ? 0 : 1;
+}
+
+#endif
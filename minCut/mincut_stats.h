@@ -0,0 +1,151 @@
+// mincut_stats.h
+// Phase timers and counters for the min-cut engines.
+//
+// Build with -DMINCUT_STATS to switch them on; without it every hook
+// below expands to nothing and the engines compile exactly as before.
+//
+// Timers are exclusive: entering a phase charges the time so far to the
+// enclosing one, so nested phases (a CSR build inside a relabel, a base
+// case inside a recursion) never count twice and the phase times add up
+// to the wall time since the last mincut_stats_take(). Everything is per
+// thread, so trials running on different threads never mix.
+//
+//   other     time outside any named phase (cut evaluation, recursion glue)
+//   gen       graph generation
+//   copy      edge-vector copies, multigraph expansion, CSR / edge-array builds
+//   contract  random contraction loops
+//   rebuild   self-loop filtering passes (CSR prefix rebuild, filtered buffers)
+//   relabel   union–find classes to 0..k-1 (unordered_map or label array)
+//   sw        Stoer–Wagner, exact runs and Karger–Stein base cases
+//
+//   contractions  successful merges
+//   self_loops    self-loop draws rejected plus self-loop edges dropped
+//   dsu_finds     find() steps: one per call plus one per parent link followed
+//   rec_nodes     Karger–Stein recursion nodes
+//   bytes_alloc   bytes requested from operator new (binaries that hook it)
+
+#ifndef MINCUT_STATS_H
+#define MINCUT_STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum MincutPhase : int {
+    MP_OTHER, MP_GEN, MP_COPY, MP_CONTRACT, MP_REBUILD, MP_RELABEL, MP_SW, MP_COUNT
+};
+
+struct MincutStats {
+    uint64_t ns[MP_COUNT];
+    uint64_t contractions, self_loops, dsu_finds, rec_nodes, bytes_alloc;
+
+    void merge(const MincutStats &o){
+        for(int p=0;p<MP_COUNT;p++) ns[p] += o.ns[p];
+        contractions += o.contractions;
+        self_loops += o.self_loops;
+        dsu_finds += o.dsu_finds;
+        rec_nodes += o.rec_nodes;
+        bytes_alloc += o.bytes_alloc;
+    }
+};
+
+#ifdef MINCUT_STATS
+constexpr bool mincut_stats_enabled = true;
+#else
+constexpr bool mincut_stats_enabled = false;
+#endif
+
+namespace mincut_stats_detail {
+
+// Plain data, so the thread_local needs no constructor (it is touched
+// from operator new)
+struct State {
+    MincutStats s;
+    int cur;
+    uint64_t since;
+};
+
+inline State& state(){
+    static thread_local State st;
+    return st;
+}
+
+inline uint64_t now_ns(){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Charges the running phase up to now and switches to p
+inline int enter(int p){
+    State &st = state();
+    uint64_t t = now_ns();
+    if(st.since) st.s.ns[st.cur] += t - st.since;
+    int prev = st.cur;
+    st.cur = p;
+    st.since = t;
+    return prev;
+}
+
+struct PhaseScope {
+    int prev;
+    explicit PhaseScope(int p) : prev(enter(p)) {}
+    ~PhaseScope(){ enter(prev); }
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+};
+
+} // namespace mincut_stats_detail
+
+#ifdef MINCUT_STATS
+#define MINCUT_CAT2(a, b) a##b
+#define MINCUT_CAT(a, b) MINCUT_CAT2(a, b)
+#define MINCUT_PHASE(p) mincut_stats_detail::PhaseScope MINCUT_CAT(mincut_phase_, __LINE__)(p)
+#define MINCUT_COUNT(field, n) (mincut_stats_detail::state().s.field += (n))
+#else
+#define MINCUT_PHASE(p) do {} while(0)
+#define MINCUT_COUNT(field, n) do {} while(0)
+#endif
+
+// Returns this thread's totals since the previous call and starts over
+inline MincutStats mincut_stats_take(){
+    using namespace mincut_stats_detail;
+    if(!mincut_stats_enabled) return MincutStats{};
+    State &st = state();
+    enter(st.cur);
+    MincutStats out = st.s;
+    st.s = MincutStats{};
+    return out;
+}
+
+// Column names "<prefix>other_ns", ..., "<prefix>bytes_alloc" (none when disabled)
+inline std::vector<std::string> mincut_stats_columns(const std::string &prefix){
+    std::vector<std::string> cols;
+    if(!mincut_stats_enabled) return cols;
+    static const char *phase[MP_COUNT] = {"other", "gen", "copy", "contract", "rebuild", "relabel", "sw"};
+    for(int p=0;p<MP_COUNT;p++) cols.push_back(prefix + phase[p] + "_ns");
+    for(const char *c : {"contractions", "self_loops", "dsu_finds", "rec_nodes", "bytes_alloc"})
+        cols.push_back(prefix + c);
+    return cols;
+}
+
+// Matching values appended to a result row. With per == 1 they go in as
+// the exact integer counts; otherwise each is divided by 'per' (trials
+// averaged into one row) and goes in as a double, so give the sink enough
+// precision for it (ResultSink's 'precision' argument).
+template<class Row>
+void mincut_stats_row(Row &row, const MincutStats &s, double per = 1){
+    if(!mincut_stats_enabled) return;
+    auto put = [&](uint64_t v){
+        if(per == 1) row << v;
+        else row << v / per;
+    };
+    for(int p=0;p<MP_COUNT;p++) put(s.ns[p]);
+    put(s.contractions);
+    put(s.self_loops);
+    put(s.dsu_finds);
+    put(s.rec_nodes);
+    put(s.bytes_alloc);
+}
+
+#endif
@@ -0,0 +1,400 @@
+// mincut_treepack.h
+// Min cut by tree packing and 2-respecting cut search, after Karger 2000:
+// exact with high probability.
+//
+// A cut C "k-respects" a spanning tree T when at most k tree edges cross
+// it. In a packing of spanning trees of value P, every tree crosses C at
+// least once and the packing puts at most val(C) on C's edges, so the
+// trees crossing it three or more times carry at most (val(C)/P - 1)/2 of
+// the packing. For a maximum packing (P >= λ/2 by Nash-Williams) and a
+// min cut C that is at most 1/2; the sampling and greedy slack below are
+// budgeted as still leaving a third of the packing 2-respecting C.
+//
+// 1. Skeleton. Each unit of weight is kept with probability
+//    p = min(1, 6 ln n / λ̂), i.e. w(e) becomes Binomial(w(e), p). With
+//    λ̂ within a factor 2 of λ the skeleton H has min cut Θ(log n) and, by
+//    Karger's sampling theorem, every cut of G keeps its relative value in
+//    H up to 1 ± ε w.h.p., so a min cut of G is near-minimum in H. λ̂
+//    starts at the minimum weighted degree (>= λ) and is halved while the
+//    packing below says H's min cut is too small for that.
+// 2. Packing. Greedy (Thorup): tree t is a minimum spanning tree of H
+//    under the relative loads uses(e) / w_H(e) left by trees 1..t-1, ties
+//    broken by a seeded random order. Trees are added until the heaviest
+//    relative load reaches 4 ln m_H, which takes O(λ_H log m) trees and
+//    brings the greedy packing within a constant factor of the maximum.
+//    Only the n - 1 tree edges change load, so the order is kept sorted by
+//    re-sorting those and merging them back: O(m) per tree.
+// 3. Search. 'trees' trees are drawn uniformly from the packing (reservoir
+//    sampling while it grows) and each is searched in G, with G's weights,
+//    for its best cut crossing one or two of its edges. If a third of the
+//    packing 2-respects a min cut, ceil(3 ln n) draws all miss it with
+//    probability (2/3)^(3 ln n) < 1/n.
+//
+// Search, for a tree rooted at vertex 0, names a tree edge by its child
+// vertex v and S_v is v's subtree. A graph edge (x, y) crosses the cut
+// through tree edges {u, v} iff exactly one of u, v lies on the tree path
+// x..y, so with C(v) = weight of the edges whose path holds v,
+//     cut(u, v) = C(u) + C(v) - 2 · w(edges whose path holds both).
+// For a fixed u, the edges whose path holds u are those leaving S_u. A
+// segment tree over the heavy-light order stores C(v) - 2·(active weight
+// on v), each active edge adding -2w along its tree path, and
+//     min over v != u of cut(u, v) = C(u) + segment minimum without u.
+// Walking a heavy path bottom-up, S_u only grows by u and u's light
+// subtrees, so an edge changes state at most once per heavy path above
+// its endpoints: O(m log n) path updates of O(log² n) each per tree.
+//
+// The result is always the weight of a real cut, and the min cut once
+// some searched tree 2-respects it; 'proven' is set when it also meets
+// mincut_lower_bound(), which certifies it outright.
+
+#ifndef MINCUT_TREEPACK_H
+#define MINCUT_TREEPACK_H
+
+#include "csr_graph.h"
+#include "mincut_budget.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+struct TreePackResult {
+    long long cut = 0;
+    int trees = 0;          // sampled trees searched
+    int packed = 0;         // trees in the final skeleton packing
+    int rounds = 0;         // skeletons tried (λ̂ halvings + 1)
+    double p = 1;           // sampling probability of the final skeleton
+    int found_at = 0;       // searched tree that gave the final cut (0: trivial cut)
+    bool proven = false;    // cut met mincut_lower_bound(), so it is the min cut
+};
+
+namespace mincut_treepack_detail {
+
+// Range add, global minimum, bottom-up over a power-of-two leaf row. A
+// node's tag applies to its whole range and is never pushed down, so
+// mn[x] = min(mn[2x], mn[2x+1]) + tag[x] and mn[1] is the global minimum.
+struct AddMinTree {
+    int size = 1;
+    std::vector<long long> mn, tag;
+
+    void init(const std::vector<long long> &a, long long pad){
+        size = 1;
+        while(size < (int)a.size()) size *= 2;
+        mn.assign(2 * size, pad);
+        tag.assign(size, 0);
+        std::copy(a.begin(), a.end(), mn.begin() + size);
+        for(int x=size-1;x>0;x--) mn[x] = std::min(mn[2 * x], mn[2 * x + 1]);
+    }
+    void fix(int x){ mn[x] = std::min(mn[2 * x], mn[2 * x + 1]) + tag[x]; }
+    void apply(int x, long long d){
+        mn[x] += d;
+        if(x < size) tag[x] += d;
+    }
+    void add(int l, int r, long long d){
+        if(l > r) return;
+        int l0 = l + size, r0 = r + size;
+        for(l+=size, r+=size+1; l<r; l/=2, r/=2){
+            if(l & 1) apply(l++, d);
+            if(r & 1) apply(--r, d);
+        }
+        // Both ends are leaves, so their ancestors pair up level by level
+        for(l0/=2, r0/=2; l0>0; l0/=2, r0/=2){
+            fix(l0);
+            if(r0 != l0) fix(r0);
+        }
+    }
+    long long global_min() const { return mn[1]; }
+};
+
+// Rooted spanning tree in heavy-light order: every heavy path and every
+// subtree is a contiguous range of pos[]
+struct HeavyLight {
+    std::vector<int> parent, depth, size, heavy, head, pos, at;
+
+    // tree[] lists n - 1 undirected edges as (a, b) pairs
+    void build(int n, const std::vector<std::pair<int,int>> &tree){
+        std::vector<int> off(n + 1, 0), nb(2 * tree.size());
+        for(const auto &[a, b] : tree){ off[a + 1]++; off[b + 1]++; }
+        for(int u=0;u<n;u++) off[u + 1] += off[u];
+        std::vector<int> fill(off.begin(), off.end() - 1);
+        for(const auto &[a, b] : tree){ nb[fill[a]++] = b; nb[fill[b]++] = a; }
+
+        parent.assign(n, -1);
+        depth.assign(n, 0);
+        size.assign(n, 1);
+        heavy.assign(n, -1);
+        std::vector<int> order;
+        order.reserve(n);
+        order.push_back(0);
+        for(size_t i=0;i<order.size();i++){
+            int u = order[i];
+            for(int j=off[u];j<off[u + 1];j++){
+                int v = nb[j];
+                if(v == parent[u]) continue;
+                parent[v] = u;
+                depth[v] = depth[u] + 1;
+                order.push_back(v);
+            }
+        }
+        for(int i=n-1;i>0;i--){
+            int v = order[i], u = parent[v];
+            size[u] += size[v];
+            if(heavy[u] < 0 || size[v] > size[heavy[u]]) heavy[u] = v;
+        }
+
+        // Preorder with the heavy child first
+        head.assign(n, 0);
+        pos.assign(n, 0);
+        at.assign(n, 0);
+        std::vector<int> stack{0};
+        int next = 0;
+        while(!stack.empty()){
+            int u = stack.back();
+            stack.pop_back();
+            head[u] = (parent[u] >= 0 && heavy[parent[u]] == u) ? head[parent[u]] : u;
+            pos[u] = next;
+            at[next++] = u;
+            for(int j=off[u];j<off[u + 1];j++){
+                int v = nb[j];
+                if(v != parent[u] && v != heavy[u]) stack.push_back(v);
+            }
+            if(heavy[u] >= 0) stack.push_back(heavy[u]);
+        }
+    }
+
+    int lca(int x, int y) const {
+        while(head[x] != head[y]){
+            if(depth[head[x]] < depth[head[y]]) std::swap(x, y);
+            x = parent[head[x]];
+        }
+        return depth[x] < depth[y] ? x : y;
+    }
+
+    // Adds d at every tree edge (child vertex) on the path x..y
+    void path_add(int x, int y, long long d, AddMinTree &seg) const {
+        while(head[x] != head[y]){
+            if(depth[head[x]] < depth[head[y]]) std::swap(x, y);
+            seg.add(pos[head[x]], pos[x], d);
+            x = parent[head[x]];
+        }
+        if(depth[x] > depth[y]) std::swap(x, y);
+        seg.add(pos[x] + 1, pos[y], d);
+    }
+};
+
+// Best cut crossing one or two edges of the spanning tree
+inline long long two_respecting_min(const CsrGraph& g, const std::vector<std::pair<int,int>> &tree){
+    int n = g.n;
+    HeavyLight hl;
+    hl.build(n, tree);
+
+    // C(v): each edge adds w at both endpoints and -2w at their LCA, then
+    // subtree sums (children follow parents in pos order)
+    std::vector<long long> C(n, 0);
+    for(int x=0;x<n;x++)
+        for(uint64_t i=g.off[x];i<g.off[x + 1];i++){
+            int y = g.adj[i];
+            if(y < x) continue;
+            C[x] += g.w[i];
+            C[y] += g.w[i];
+            C[hl.lca(x, y)] -= 2LL * g.w[i];
+        }
+    for(int p=n-1;p>0;p--){
+        int v = hl.at[p];
+        C[hl.parent[v]] += C[v];
+    }
+
+    // The root has no tree edge: its slot stays out of reach, as does u's
+    // own slot while u is the first cut edge
+    const long long INF = LLONG_MAX / 4;
+    std::vector<long long> init(n);
+    for(int p=0;p<n;p++) init[p] = p == 0 ? INF : C[hl.at[p]];
+    AddMinTree seg;
+    seg.init(init, INF);
+
+    long long best = INF;
+    // side[x]: 0 outside S_u, 1 inside, 2 in the batch being added. An
+    // edge inside the batch was and stays uncut, so it is never touched.
+    std::vector<char> side(n, 0);
+    std::vector<int> batch, entered;
+    auto add_batch = [&](){
+        for(int x : batch) side[x] = 2;
+        for(int x : batch)
+            for(uint64_t i=g.off[x];i<g.off[x + 1];i++){
+                int y = g.adj[i];
+                if(side[y] == 1) hl.path_add(x, y, 2LL * g.w[i], seg);
+                else if(side[y] == 0) hl.path_add(x, y, -2LL * g.w[i], seg);
+            }
+        for(int x : batch) side[x] = 1;
+        entered.insert(entered.end(), batch.begin(), batch.end());
+        batch.clear();
+    };
+
+    for(int top=0;top<n;top++){
+        if(hl.head[top] != top) continue;
+        int bottom = top;
+        while(hl.heavy[bottom] >= 0) bottom = hl.heavy[bottom];
+
+        // The root has no tree edge above it, so its path stops below it
+        for(int u=bottom;u!=0;u=hl.parent[u]){
+            // S_u = S_heavy ∪ {u} ∪ light subtrees; the latter two are new
+            int p = hl.pos[u], skip = hl.heavy[u] >= 0 ? hl.size[hl.heavy[u]] : 0;
+            batch.push_back(u);
+            for(int q=p+1+skip;q<p+hl.size[u];q++) batch.push_back(hl.at[q]);
+            add_batch();
+
+            seg.add(p, p, INF);
+            long long other = seg.global_min();
+            seg.add(p, p, -INF);
+            best = std::min(best, C[u]);
+            if(other < INF / 2) best = std::min(best, C[u] + other);
+            if(u == top) break;
+        }
+
+        // Undo: the active edges are exactly those leaving the entered set
+        for(int x : entered)
+            for(uint64_t i=g.off[x];i<g.off[x + 1];i++)
+                if(!side[g.adj[i]]) hl.path_add(x, g.adj[i], 2LL * g.w[i], seg);
+        for(int x : entered) side[x] = 0;
+        entered.clear();
+    }
+    return best;
+}
+
+// Greedy packing on the skeleton (src, dst, wh), up to a heaviest relative
+// load of 'load'. 'keep' trees are reservoir-sampled into 'sample'; returns
+// the packing value, trees / heaviest load, or 0 if the skeleton is
+// disconnected.
+inline double greedy_pack(int n, const std::vector<uint32_t> &src, const std::vector<uint32_t> &dst,
+                          const std::vector<uint32_t> &wh, double load, int keep, std::mt19937 &rng,
+                          std::vector<std::vector<std::pair<int,int>>> &sample, int &packed){
+    size_t m = src.size();
+    std::vector<uint32_t> order(m), uses(m, 0), rest, moved, merged;
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+    auto lighter = [&](uint32_t a, uint32_t b){
+        return (uint64_t)uses[a] * wh[b] < (uint64_t)uses[b] * wh[a];
+    };
+    std::vector<char> in_tree(m, 0);
+    std::vector<std::pair<int,int>> tree;
+    tree.reserve(n - 1);
+    rest.reserve(m);
+    merged.reserve(m);
+
+    sample.clear();
+    packed = 0;
+    double heaviest = 0;
+    while(heaviest < load){
+        CsrUnionFind uf(n);
+        tree.clear();
+        moved.clear();
+        for(uint32_t e : order){
+            if(!uf.unite(src[e], dst[e])) continue;
+            uses[e]++;
+            in_tree[e] = 1;
+            moved.push_back(e);
+            tree.emplace_back(src[e], dst[e]);
+            heaviest = std::max(heaviest, (double)uses[e] / wh[e]);
+            if(uf.comp == 1) break;
+        }
+        if(uf.comp > 1) return 0;
+
+        packed++;
+        if((int)sample.size() < keep) sample.push_back(tree);
+        else if(uint32_t j = rng() % packed; (int)j < keep) sample[j] = tree;
+
+        // Kruskal order for the next tree: the untouched edges are still
+        // sorted, the tree edges moved up and are re-sorted and merged in
+        rest.clear();
+        for(uint32_t e : order) if(!in_tree[e]) rest.push_back(e);
+        std::stable_sort(moved.begin(), moved.end(), lighter);
+        merged.clear();
+        std::merge(rest.begin(), rest.end(), moved.begin(), moved.end(),
+                   std::back_inserter(merged), lighter);
+        order.swap(merged);
+        for(uint32_t e : moved) in_tree[e] = 0;
+    }
+    return packed / heaviest;
+}
+
+} // namespace mincut_treepack_detail
+
+// Skeleton min cut target: p = min(1, TP_SKELETON_C · ln n / λ̂)
+constexpr double TP_SKELETON_C = 6.0;
+// Packing length: trees are added until the heaviest relative load
+// reaches TP_LOAD_C · ln m
+constexpr double TP_LOAD_C = 4.0;
+
+// Default number of sampled trees searched: ceil(3 ln n), enough that a
+// third of the packing 2-respecting the min cut is missed with
+// probability below 1/n
+inline int treepack_default_trees(int n){
+    return std::max(4, (int)std::ceil(3.0 * std::log(std::max(n, 2))));
+}
+
+// Min cut, exact w.h.p.: samples a skeleton, packs it greedily and searches
+// 'trees' trees drawn from the packing (0: treepack_default_trees); see the
+// top of this file. Returns at once when the minimum weighted degree meets
+// mincut_lower_bound(), and stops searching when the cut does (r.proven is
+// set then); a disconnected graph has cut 0.
+inline TreePackResult treepack_mincut(const CsrGraph& g, int trees = 0, uint32_t seed = 1){
+    using namespace mincut_treepack_detail;
+    TreePackResult r;
+    if(g.n <= 1){ r.proven = true; return r; }
+    if(trees <= 0) trees = treepack_default_trees(g.n);
+
+    EdgeArrays ea = upper_edges(g);
+    size_t m = ea.src.size();
+    CsrUnionFind uf(g.n);
+    for(size_t e=0;e<m;e++) uf.unite(ea.src[e], ea.dst[e]);
+    if(uf.comp > 1){ r.cut = 0; r.proven = true; return r; }
+
+    // Trivial cuts first: the lightest vertex is free to check
+    r.cut = min_weighted_degree(g);
+    long long lower = mincut_lower_bound(g);
+    if(r.cut <= lower){ r.proven = true; return r; }
+
+    std::mt19937 rng(seed);
+    double log_n = std::log((double)g.n);
+    double lambda = (double)r.cut;
+    std::vector<uint32_t> src, dst, wh;
+    std::vector<std::vector<std::pair<int,int>>> sample;
+    for(;;){
+        r.rounds++;
+        r.p = std::min(1.0, TP_SKELETON_C * log_n / lambda);
+        src.clear(); dst.clear(); wh.clear();
+        for(size_t e=0;e<m;e++){
+            uint32_t k = ea.w[e];
+            if(r.p < 1) k = std::binomial_distribution<uint32_t>(ea.w[e], r.p)(rng);
+            if(k == 0) continue;
+            src.push_back(ea.src[e]);
+            dst.push_back(ea.dst[e]);
+            wh.push_back(k);
+        }
+        double load = TP_LOAD_C * std::log((double)std::max<size_t>(src.size(), 2));
+        double value = greedy_pack(g.n, src, dst, wh, load, trees, rng, sample, r.packed);
+        if(r.p >= 1){
+            // Only zero-weight edges hold G together: they are a cut of 0
+            if(value == 0){ r.cut = 0; r.proven = true; return r; }
+            break;
+        }
+        // Packing value is at most H's min cut: accept once it shows that
+        // is at least half the target, else λ̂ was too high
+        if(value >= TP_SKELETON_C * log_n / 2) break;
+        lambda /= 2;
+    }
+
+    for(size_t t=0;t<sample.size() && r.cut > lower;t++){
+        r.trees = t + 1;
+        long long c = two_respecting_min(g, sample[t]);
+        if(c < r.cut){ r.cut = c; r.found_at = t + 1; }
+    }
+    r.proven = r.cut <= lower;
+    return r;
+}
+
+#endif
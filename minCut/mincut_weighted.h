@@ -0,0 +1,224 @@
+// mincut_weighted.h
+// Weighted-edge engines shared by both binaries.
+//
+// A multigraph's parallel edges collapse into one WEdge (u, v, w), so an
+// input with heavy weights costs O(unique pairs), never O(total weight).
+// Karger contraction draws an edge with probability proportional to its
+// weight, which is exactly "pick one of the parallel copies uniformly";
+// Stoer–Wagner runs on the flat matrix (sw_dense.h) or the CSR heap
+// engine (csr_graph.h), picked by density and total weight.
+
+#ifndef MINCUT_WEIGHTED_H
+#define MINCUT_WEIGHTED_H
+
+#include "csr_graph.h"
+#include "mincut_stats.h"
+#include "sw_dense.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Weighted edge: the parallel edges of a multigraph collapse into one (u, v, w)
+struct WEdge { int u, v, w; };
+
+// ------------------------------------------------------------
+// Parallel-edge merging
+// Sorts by (min, max) endpoint and sums the weights of equal pairs;
+// self-loops are dropped. A multigraph with m edges shrinks to its
+// unique pairs.
+// ------------------------------------------------------------
+inline std::vector<WEdge> merge_parallel(std::vector<WEdge> edges){
+    for(auto &e : edges) if(e.u > e.v) std::swap(e.u, e.v);
+    std::sort(edges.begin(), edges.end(), [](const WEdge &a, const WEdge &b){
+        return a.u != b.u ? a.u < b.u : a.v < b.v;
+    });
+
+    size_t out = 0;
+    for(size_t i=0;i<edges.size();i++){
+        const WEdge &e = edges[i];
+        if(e.u == e.v) continue;
+        if(out > 0 && edges[out-1].u == e.u && edges[out-1].v == e.v)
+            edges[out-1].w += e.w;
+        else
+            edges[out++] = e;
+    }
+    edges.resize(out);
+    return edges;
+}
+
+// The u < v half of a CsrGraph as weighted edges
+inline std::vector<WEdge> csr_to_wedges(const CsrGraph &g){
+    std::vector<WEdge> edges;
+    edges.reserve(g.edges());
+    for(int u=0;u<g.n;u++)
+        for(uint64_t k=g.off[u];k<g.off[u+1];k++)
+            if((int)g.adj[k] > u) edges.push_back({u, (int)g.adj[k], (int)g.w[k]});
+    return edges;
+}
+
+inline CsrGraph wedges_to_csr(int n, const std::vector<WEdge>& edges){
+    return build_csr(n, edges.size(), [&](size_t i, int &u, int &v, int &w){
+        u = edges[i].u; v = edges[i].v; w = edges[i].w;
+    });
+}
+
+// ------------------------------------------------------------
+// Stoer–Wagner, sparse (CSR + indexed heap, see csr_graph.h)
+// Each phase is a maximum-adjacency ordering driven by the heap, so it
+// costs O(m log n) instead of O(n²), and memory is O(n + m) instead of
+// the n×n matrix.
+// ------------------------------------------------------------
+inline long long stoer_wagner_sparse(int N, const std::vector<WEdge>& edges){
+    return stoer_wagner_csr(wedges_to_csr(N, edges));
+}
+
+// ------------------------------------------------------------
+// Stoer–Wagner, dense on the flat matrix (sw_dense.h)
+// Physical compaction on merge and AVX2 update/argmax; the total weight
+// must stay below 2^30.
+// ------------------------------------------------------------
+inline int stoer_wagner_flat(int N, const std::vector<WEdge>& edges, bool simd = true){
+    return stoer_wagner_flat(N, edges.size(), [&](size_t i, int &u, int &v, int &w){
+        u = edges[i].u; v = edges[i].v; w = edges[i].w;
+    }, simd);
+}
+
+// Density rule for the engine pick (m counts unique pairs): the heap
+// engine costs ~n·m·log n, the flat matrix ~n³ at about 1/40 of the cost
+// per step (--bench-sw puts the crossover near Erdős n=2000, p=10/n)
+inline bool sw_prefers_sparse(int N, double m){
+    return N > 2 && 40.0 * m * std::log2((double)N) < (double)N * N;
+}
+
+// The flat matrix also needs a total weight below 2^30; heavier graphs go
+// sparse, which is also why the cut comes back as long long
+inline long long stoer_wagner_auto(int N, const std::vector<WEdge>& edges){
+    long long total = 0;
+    for(const auto &e : edges) total += e.w;
+    if(total >= (1LL << 30) || sw_prefers_sparse(N, edges.size()))
+        return stoer_wagner_sparse(N, edges);
+    return stoer_wagner_flat(N, edges);
+}
+
+// ------------------------------------------------------------
+// Weighted Karger / Karger–Stein
+// Selection walks a Fenwick tree over the weights in O(log m); an edge
+// that has become a self-loop gets weight 0, so it is never drawn again
+// and nothing is rescanned.
+// ------------------------------------------------------------
+struct Fenwick {
+    int n;
+    std::vector<long long> t;
+    explicit Fenwick(const std::vector<WEdge>& edges) : n(edges.size()), t(n + 1, 0) {
+        for(int i=0;i<n;i++){
+            t[i+1] += edges[i].w;
+            int j = (i+1) + ((i+1) & -(i+1));
+            if(j <= n) t[j] += t[i+1];
+        }
+    }
+    long long total() const {
+        long long s = 0;
+        for(int i=n;i>0;i-=i&-i) s += t[i];
+        return s;
+    }
+    void add(int i, long long d){ for(i++;i<=n;i+=i&-i) t[i] += d; }
+    // Smallest index whose prefix sum exceeds x (0 <= x < total)
+    int find(long long x) const {
+        int pos = 0;
+        for(int step = 1 << (31 - __builtin_clz(std::max(n,1))); step; step >>= 1){
+            if(pos + step <= n && t[pos + step] <= x){
+                pos += step;
+                x -= t[pos];
+            }
+        }
+        return pos;
+    }
+};
+
+// Contracts down to 'target' super-vertices; uf holds the result
+inline void contract_weighted(int n, const std::vector<WEdge>& edges, int target,
+                              std::mt19937 &rng, CsrUnionFind &uf){
+    MINCUT_PHASE(MP_CONTRACT);
+    uf = CsrUnionFind(n);
+    Fenwick fw(edges);
+    std::vector<int> w(edges.size());
+    for(size_t i=0;i<edges.size();i++) w[i] = edges[i].w;
+    long long total = fw.total();
+
+    while(uf.comp > target && total > 0){
+        std::uniform_int_distribution<long long> dist(0, total-1);
+        int idx = fw.find(dist(rng));
+        const WEdge &e = edges[idx];
+        if(uf.unite(e.u, e.v)) MINCUT_COUNT(contractions, 1);
+        else MINCUT_COUNT(self_loops, 1);
+
+        // Picked edge is a self-loop now either way: retire it
+        fw.add(idx, -w[idx]);
+        total -= w[idx];
+        w[idx] = 0;
+    }
+}
+
+inline long long karger_once_weighted(int n, const std::vector<WEdge>& edges, std::mt19937 &rng){
+    CsrUnionFind uf(0);
+    contract_weighted(n, edges, 2, rng, uf);
+
+    long long cut = 0;
+    for(const auto &e : edges)
+        if(uf.find(e.u) != uf.find(e.v)) cut += e.w;
+    return cut;
+}
+
+// Contracted graph is relabeled 0..id-1 and its parallel edges re-merged
+inline std::pair<int, std::vector<WEdge>>
+contract_until_weighted(int n, const std::vector<WEdge>& edges, int target, std::mt19937 &rng){
+    if(target >= n) return {n, edges};
+
+    CsrUnionFind uf(0);
+    contract_weighted(n, edges, target, rng, uf);
+
+    MINCUT_PHASE(MP_RELABEL);
+    std::vector<int> label(n, -1);
+    int id = 0;
+    for(int i=0;i<n;i++){
+        int r = uf.find(i);
+        if(label[r] < 0) label[r] = id++;
+    }
+
+    std::vector<WEdge> out;
+    out.reserve(edges.size());
+    for(const auto &e : edges){
+        int a = label[uf.find(e.u)], b = label[uf.find(e.v)];
+        if(a != b) out.push_back({a, b, e.w});
+    }
+    return {id, merge_parallel(std::move(out))};
+}
+
+inline long long karger_stein_weighted_rec(int n, const std::vector<WEdge>& edges, std::mt19937 &rng){
+    MINCUT_COUNT(rec_nodes, 1);
+    if(n <= 20)
+        return stoer_wagner_auto(n, edges);
+
+    int t = (int)std::ceil(n / std::sqrt(2.0));
+
+    uint32_t s1 = rng();
+    uint32_t s2 = rng();
+    std::mt19937 r1(s1), r2(s2);
+
+    auto [n1, e1] = contract_until_weighted(n, edges, t, r1);
+    long long c1 = karger_stein_weighted_rec(n1, e1, r1);
+    auto [n2, e2] = contract_until_weighted(n, edges, t, r2);
+    long long c2 = karger_stein_weighted_rec(n2, e2, r2);
+
+    return std::min(c1, c2);
+}
+
+inline long long karger_stein_weighted(int n, const std::vector<WEdge>& edges, std::mt19937 &rng){
+    return karger_stein_weighted_rec(n, edges, rng);
+}
+
+#endif
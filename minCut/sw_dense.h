@@ -0,0 +1,182 @@
+// sw_dense.h
+// Dense Stoer–Wagner on one flat, row-padded weight matrix.
+//
+// Rows are 'stride' ints apart, with stride = n rounded up to 8, so every
+// row is a whole number of 256-bit lanes and the padding columns stay 0.
+// Live vertices always sit at indices 0..n-1: merging t into s folds row
+// and column t into s, then the last vertex moves into t's slot. The
+// inner loops therefore index rows directly, with no vertex map.
+//
+// A phase keeps key[j] = adjacency of j to the added set. An added
+// vertex's key drops to DONE, a large negative value, so the update is an
+// unconditional key += row and added vertices never win the argmax. The
+// update and argmax are fused into one pass with an AVX2 version picked
+// at run time, so the default build flags still work on any x86-64 (and
+// elsewhere through the scalar loop).
+//
+// Weights are int like the other dense engines; the total edge weight
+// must stay below 2^30 so DONE + weight cannot reach a live key.
+
+#ifndef SW_DENSE_H
+#define SW_DENSE_H
+
+#include "mincut_stats.h"
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SW_DENSE_X86 1
+#endif
+
+namespace sw_dense_detail {
+
+constexpr int DONE = INT_MIN / 2;
+
+// key[0..len) += row[0..len), returns the first index of the new maximum
+inline int add_row_argmax_scalar(int *key, const int *row, int len){
+    int best = 0;
+    for(int j=0;j<len;j++){
+        key[j] += row[j];
+        if(key[j] > key[best]) best = j;
+    }
+    return best;
+}
+
+#ifdef SW_DENSE_X86
+// Same contract, len a multiple of 8: one pass adds and tracks the lane
+// maxima, a second pass finds the first lane equal to the maximum
+__attribute__((target("avx2")))
+inline int add_row_argmax_avx2(int *key, const int *row, int len){
+    __m256i vmax = _mm256_set1_epi32(INT_MIN);
+    for(int j=0;j<len;j+=8){
+        __m256i k = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(key + j)),
+                                     _mm256_loadu_si256((const __m256i*)(row + j)));
+        _mm256_storeu_si256((__m256i*)(key + j), k);
+        vmax = _mm256_max_epi32(vmax, k);
+    }
+    __m128i m = _mm_max_epi32(_mm256_castsi256_si128(vmax), _mm256_extracti128_si256(vmax, 1));
+    m = _mm_max_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+    m = _mm_max_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+    __m256i target = _mm256_broadcastd_epi32(m);
+
+    for(int j=0;j<len;j+=8){
+        __m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(key + j)), target);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+        if(mask) return j + __builtin_ctz(mask);
+    }
+    return 0;
+}
+
+// dst[0..len) += src[0..len), len a multiple of 8
+__attribute__((target("avx2")))
+inline void add_row_avx2(int *dst, const int *src, int len){
+    for(int j=0;j<len;j+=8){
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + j));
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + j));
+        _mm256_storeu_si256((__m256i*)(dst + j), _mm256_add_epi32(d, s));
+    }
+}
+#endif
+
+inline bool has_avx2(){
+#ifdef SW_DENSE_X86
+    static const bool ok = __builtin_cpu_supports("avx2");
+    return ok;
+#else
+    return false;
+#endif
+}
+
+// Matrix and key buffers, reused across calls on the same thread (the
+// Karger–Stein base case calls in here thousands of times per run)
+struct Scratch {
+    std::vector<int> w, key;
+};
+
+inline Scratch& scratch(){
+    static thread_local Scratch s;
+    return s;
+}
+
+} // namespace sw_dense_detail
+
+// Min cut of an n-vertex graph given as m edges; edge(i, u, v, w) fills in
+// the i-th one. simd = false forces the scalar loops (for benchmarks).
+template<class EdgeFn>
+int stoer_wagner_flat(int n, size_t m, EdgeFn edge, bool simd = true){
+    using namespace sw_dense_detail;
+    if(n <= 1) return 0;
+    MINCUT_PHASE(MP_SW);
+
+    const int stride = (n + 7) & ~7;
+    Scratch &S = scratch();
+    S.w.assign((size_t)n * stride, 0);
+    S.key.resize(stride);
+    int *W = S.w.data(), *key = S.key.data();
+
+    for(size_t i=0;i<m;i++){
+        int u, v, wt;
+        edge(i, u, v, wt);
+        if(u == v) continue;
+        W[(size_t)u * stride + v] += wt;
+        W[(size_t)v * stride + u] += wt;
+    }
+
+#ifdef SW_DENSE_X86
+    const bool vec = simd && has_avx2();
+#else
+    const bool vec = false;
+    (void)simd;
+#endif
+    auto add_row_argmax = [&](const int *row){
+#ifdef SW_DENSE_X86
+        if(vec) return add_row_argmax_avx2(key, row, stride);
+#endif
+        return add_row_argmax_scalar(key, row, stride);
+    };
+    auto add_row = [&](int *dst, const int *src, int len){
+#ifdef SW_DENSE_X86
+        if(vec){ add_row_avx2(dst, src, len); return; }
+#endif
+        for(int j=0;j<len;j++) dst[j] += src[j];
+    };
+
+    int best = INT_MAX;
+    while(n > 1){
+        // Phase from vertex 0; the padding keys start (and stay) at DONE
+        std::fill(key, key + n, 0);
+        std::fill(key + n, key + stride, DONE);
+        key[0] = DONE;
+        int prev = -1, last = 0, phase_cut = 0;
+        for(int i=1;i<n;i++){
+            int sel = add_row_argmax(W + (size_t)last * stride);
+            phase_cut = key[sel];
+            key[sel] = DONE;
+            prev = last;
+            last = sel;
+        }
+        best = std::min(best, phase_cut);
+
+        // Merge t into s, then move the last row/column into t's slot
+        const int s = prev, t = last, l = n - 1;
+        int *rs = W + (size_t)s * stride;
+        add_row(rs, W + (size_t)t * stride, stride);
+        rs[s] = 0;
+        for(int j=0;j<n;j++) W[(size_t)j * stride + s] = rs[j];
+
+        if(t != l){
+            std::copy(W + (size_t)l * stride, W + (size_t)l * stride + stride, W + (size_t)t * stride);
+            for(int j=0;j<n;j++) W[(size_t)j * stride + t] = W[(size_t)j * stride + l];
+            W[(size_t)t * stride + t] = 0;
+        }
+        // Column l becomes padding
+        for(int j=0;j<l;j++) W[(size_t)j * stride + l] = 0;
+        n--;
+    }
+    return best;
+}
+
+#endif
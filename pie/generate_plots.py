@@ -3,6 +3,11 @@ import matplotlib.pyplot as plt
 import seaborn as sns
 import numpy as np
 import os
+import sys
+
+# CSV or the typed .col files written by common/result_sink.h
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "common"))
+from result_sink import read_results
 
 # Configuration
 INPUT_FILE = "results.csv"
@@ -13,7 +18,7 @@ REAL_PI = 3.1415926535
 def main():
     print(f"Loading data from {INPUT_FILE}...")
     try:
-        df = pd.read_csv(INPUT_FILE)
+        df = read_results(INPUT_FILE)
     except FileNotFoundError:
         print("Error: results.csv not found.")
         return
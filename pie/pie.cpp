@@ -5,6 +5,10 @@
 #include <chrono>
 #include <fstream>
 #include <iomanip>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include "../common/result_sink.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -32,17 +36,66 @@ random_device rd;
 mt19937 gen(rd());
 uniform_real_distribution<> dis(0.0, 1.0);
 
+// ==========================================
+// COORDINATE TYPES
+// ==========================================
+// Every estimator is a template over the coordinate type of its darts.
+// Dart<T> says how to draw a coordinate in [0, 1), reflect it (for the
+// antithetic pair), place it in a grid cell, and test x^2 + y^2 <= 1.
+//   double    53-bit coordinates from dis(gen), as before
+//   float     24-bit coordinates from one 32-bit draw; twice the lanes
+//   uint32_t  u = x / 2^32 from one 32-bit draw; the test is exact
+// Darts are drawn a block at a time and counted in a separate loop, so
+// the compiler can vectorize the inside test.
+const int BLOCK = 1024;
+
+template <typename T> struct Dart;
+
+template <> struct Dart<double> {
+    static double draw() { return dis(gen); }
+    static double flip(double u) { return 1.0 - u; }
+    static double cell(int i, double u, int side) { return (i + u) * (1.0 / side); }
+    static bool inside(double x, double y) { return x * x + y * y <= 1.0; }
+};
+
+template <> struct Dart<float> {
+    static float draw() { return (gen() >> 8) * 0x1p-24f; }
+    static float flip(float u) { return 1.0f - u; }
+    static float cell(int i, float u, int side) { return (i + u) * (1.0f / side); }
+    static bool inside(float x, float y) { return x * x + y * y <= 1.0f; }
+};
+
+template <> struct Dart<uint32_t> {
+    static uint32_t draw() { return gen(); }
+    // Reflects the lattice 0..2^32-1 onto itself
+    static uint32_t flip(uint32_t u) { return ~u; }
+    // Cell i covers [i * 2^32 / side, (i + 1) * 2^32 / side)
+    static uint32_t cell(int i, uint32_t u, int side) { return (((uint64_t)i << 32) | u) / side; }
+    // x^2 + y^2 <= 2^64, i.e. x^2 <= 2^64 - y^2. ~b is 2^64 - 1 - b, which is
+    // still exact: 2^64 is not a sum of two squares below it (only
+    // (2^32)^2 + 0^2 is).
+    static bool inside(uint32_t x, uint32_t y) {
+        uint64_t a = (uint64_t)x * x, b = (uint64_t)y * y;
+        return a <= ~b;
+    }
+};
+
 // ==========================================
 // 1. BASIC MONTE CARLO
 // ==========================================
 // Just throw N darts randomly at the square.
+template <typename T>
 double piBasic(int n) {
     int inside = 0;
-    for (int i = 0; i < n; i++) {
-        double x = dis(gen);
-        double y = dis(gen);
-        if (x * x + y * y <= 1.0) {
-            inside++;
+    T x[BLOCK], y[BLOCK];
+    for (int done = 0; done < n; done += BLOCK) {
+        int len = min(BLOCK, n - done);
+        for (int i = 0; i < len; i++) {
+            x[i] = Dart<T>::draw();
+            y[i] = Dart<T>::draw();
+        }
+        for (int i = 0; i < len; i++) {
+            inside += Dart<T>::inside(x[i], y[i]);
         }
     }
     return 4.0 * inside / n;
@@ -53,27 +106,24 @@ double piBasic(int n) {
 // ==========================================
 // Divide square into 100 smaller squares.
 // We force exactly N/100 points into each small square.
+template <typename T>
 double piStratified(int n) {
     int inside = 0;
     int grid_side = 10; // 10x10 grid
     int points_per_cell = n / (grid_side * grid_side);
-    
-    // Scale factor for grid position (0.1)
-    double step = 1.0 / grid_side;
+    T x[BLOCK], y[BLOCK];
 
     for (int i = 0; i < grid_side; i++) {
         for (int j = 0; j < grid_side; j++) {
-            for (int k = 0; k < points_per_cell; k++) {
-                // Generate local random coordinate within the cell
-                double local_x = dis(gen);
-                double local_y = dis(gen);
-                
-                // Map to global coordinate
-                double x = (i + local_x) * step;
-                double y = (j + local_y) * step;
-
-                if (x * x + y * y <= 1.0) {
-                    inside++;
+            for (int done = 0; done < points_per_cell; done += BLOCK) {
+                int len = min(BLOCK, points_per_cell - done);
+                // Local random coordinate within the cell, mapped to global
+                for (int k = 0; k < len; k++) {
+                    x[k] = Dart<T>::cell(i, Dart<T>::draw(), grid_side);
+                    y[k] = Dart<T>::cell(j, Dart<T>::draw(), grid_side);
+                }
+                for (int k = 0; k < len; k++) {
+                    inside += Dart<T>::inside(x[k], y[k]);
                 }
             }
         }
@@ -90,21 +140,23 @@ double piStratified(int n) {
 // For every point (u, v), we also check (1-u, 1-v).
 // This creates negative correlation; if (u,v) is close to (0,0) (inside),
 // then (1-u, 1-v) is close to (1,1) (outside).
+template <typename T>
 double piAntithetic(int n) {
     int inside = 0;
     int pairs = n / 2;
+    T u[BLOCK], v[BLOCK];
 
-    for (int i = 0; i < pairs; i++) {
-        double u = dis(gen);
-        double v = dis(gen);
-
-        // Point 1
-        if (u * u + v * v <= 1.0) inside++;
-
-        // Point 2 (Antithetic)
-        double u2 = 1.0 - u;
-        double v2 = 1.0 - v;
-        if (u2 * u2 + v2 * v2 <= 1.0) inside++;
+    for (int done = 0; done < pairs; done += BLOCK) {
+        int len = min(BLOCK, pairs - done);
+        for (int i = 0; i < len; i++) {
+            u[i] = Dart<T>::draw();
+            v[i] = Dart<T>::draw();
+        }
+        for (int i = 0; i < len; i++) {
+            // Point 1, then point 2 (antithetic)
+            inside += Dart<T>::inside(u[i], v[i]);
+            inside += Dart<T>::inside(Dart<T>::flip(u[i]), Dart<T>::flip(v[i]));
+        }
     }
     
     return 4.0 * inside / (pairs * 2);
@@ -113,51 +165,60 @@ double piAntithetic(int n) {
 // ==========================================
 // MAIN BENCHMARK
 // ==========================================
-int main() {
-    ofstream csvFile("results.csv");
-    
+// Every estimator at every precision; the double columns keep their
+// original names, the others get a _f32 / _u32 suffix
+struct Estimator {
+    string name;
+    double (*run)(int);
+};
+
+const vector<Estimator> ESTIMATORS = {
+    {"Basic", piBasic<double>},
+    {"Strat", piStratified<double>},
+    {"Anti", piAntithetic<double>},
+    {"Basic_f32", piBasic<float>},
+    {"Strat_f32", piStratified<float>},
+    {"Anti_f32", piAntithetic<float>},
+    {"Basic_u32", piBasic<uint32_t>},
+    {"Strat_u32", piStratified<uint32_t>},
+    {"Anti_u32", piAntithetic<uint32_t>},
+};
+
+int main(int argc, char** argv) {
+    // results.csv unless given a path; a .col path writes the typed column
+    // file instead (see ../common/result_sink.h)
+    string outPath = argc > 1 ? argv[1] : "results.csv";
+
     // Header
-    csvFile << "Size,Run_ID,"
-            << "Time_Basic,Est_Basic,Err_Basic,"
-            << "Time_Strat,Est_Strat,Err_Strat,"
-            << "Time_Anti,Est_Anti,Err_Anti" << endl;
+    vector<string> columns = {"Size", "Run_ID"};
+    for (const Estimator& e : ESTIMATORS) {
+        columns.push_back("Time_" + e.name);
+        columns.push_back("Est_" + e.name);
+        columns.push_back("Err_" + e.name);
+    }
+    // Rows are queued and written by a background thread, off the timed path
+    ResultSink csvFile(outPath, columns);
 
     cout << "Starting Simulation... (This might take a moment for N=1,000,000)" << endl;
 
     for (int n : SIZES) {
         cout << "Running for Size: " << n << endl;
         for (int k = 1; k <= NUM_RUNS; k++) {
-            
-            // --- Basic ---
-            auto t1 = high_resolution_clock::now();
-            double valBasic = piBasic(n);
-            auto t2 = high_resolution_clock::now();
-            double timeBasic = duration_cast<microseconds>(t2 - t1).count() / 1000.0;
-            double errBasic = abs(valBasic - REAL_PI);
-
-            // --- Stratified ---
-            auto t3 = high_resolution_clock::now();
-            double valStrat = piStratified(n);
-            auto t4 = high_resolution_clock::now();
-            double timeStrat = duration_cast<microseconds>(t4 - t3).count() / 1000.0;
-            double errStrat = abs(valStrat - REAL_PI);
-
-            // --- Antithetic ---
-            auto t5 = high_resolution_clock::now();
-            double valAnti = piAntithetic(n);
-            auto t6 = high_resolution_clock::now();
-            double timeAnti = duration_cast<microseconds>(t6 - t5).count() / 1000.0;
-            double errAnti = abs(valAnti - REAL_PI);
-
-            // Write to CSV
-            csvFile << n << "," << k << ","
-                    << timeBasic << "," << valBasic << "," << errBasic << ","
-                    << timeStrat << "," << valStrat << "," << errStrat << ","
-                    << timeAnti << "," << valAnti << "," << errAnti << endl;
+            auto row = csvFile.row();
+            row << n << k;
+            for (const Estimator& e : ESTIMATORS) {
+                auto t1 = high_resolution_clock::now();
+                double val = e.run(n);
+                auto t2 = high_resolution_clock::now();
+                double time = duration_cast<microseconds>(t2 - t1).count() / 1000.0;
+                double err = abs(val - REAL_PI);
+
+                row << time << val << err;
+            }
         }
     }
 
     csvFile.close();
-    cout << "Done! Data written to results.csv" << endl;
+    cout << "Done! Data written to " << outPath << endl;
     return 0;
-}
\ No newline at end of file
+}
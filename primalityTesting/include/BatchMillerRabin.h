@@ -0,0 +1,50 @@
+#ifndef BATCH_MILLER_RABIN_H
+#define BATCH_MILLER_RABIN_H
+
+#include "PrimalityTester.h"
+#include <cstdint>
+#include <vector>
+
+// Multi-buffer Miller-Rabin.
+//
+// Instead of one mpz_powm at a time, candidates with the same size are
+// packed into groups of LANES and exponentiated in lockstep: limb j of every
+// lane sits next to each other, so one vector instruction advances all lanes.
+// Numbers are held in radix 2^52 (Montgomery form), which is what the
+// AVX-512 IFMA madd52lo/madd52hi instructions multiply natively.
+// Without IFMA the same layout runs through a portable scalar kernel.
+class BatchMillerRabin : public PrimalityTester {
+public:
+    static const int LANES = 8;
+
+    BatchMillerRabin();
+
+    // Single-number interface (a batch of one, padded)
+    bool test(const mpz_class& n, int k) override;
+    std::string name() const override { return "Miller-Rabin (batch)"; }
+
+    // Tests every number in ns; result[i] is 1 for probable prime
+    std::vector<char> testBatch(const std::vector<mpz_class>& ns, int k);
+
+    // Force the portable kernel even if the CPU has IFMA
+    void setScalarKernel(bool scalar);
+    bool usingSimd() const { return simd; }
+
+    // Candidates that went through the lane kernel (the rest were trivial cases)
+    unsigned long long laneTested() const { return lanesTested; }
+
+private:
+    // Runs k rounds on up to LANES odd candidates (all with the same limb count)
+    void testGroup(const mpz_class* const* ns, int count, int limbs, int k, char* out);
+
+    void montMul(uint64_t* out, const uint64_t* a, const uint64_t* b);
+
+    bool simd;
+    unsigned long long lanesTested = 0;
+
+    // Per-group state, lane-interleaved: element [j * LANES + lane]
+    int L = 0;
+    std::vector<uint64_t> N, n0inv, one, minusOne, T;
+};
+
+#endif
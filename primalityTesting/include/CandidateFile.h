@@ -0,0 +1,73 @@
+#ifndef CANDIDATE_FILE_H
+#define CANDIDATE_FILE_H
+
+#include <gmpxx.h>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Compact binary candidate format (.bin)
+//
+//   Header (32 bytes):
+//     char     magic[8]   = "PRIMBIN1"
+//     uint32   version    = 1
+//     uint32   limbBytes  = 8
+//     uint64   count      (numbers in the file)
+//     uint64   maxLimbs   (largest record, used to pre-size buffers)
+//   Then 'count' records:
+//     uint64   limbs
+//     uint64   limb[limbs]  (little-endian, least significant limb first)
+//
+// Everything is 8-byte aligned, so an mmap'd file can be handed to
+// mpz_import directly without any decimal parsing.
+
+struct CandidateHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t limbBytes;
+    uint64_t count;
+    uint64_t maxLimbs;
+};
+
+// Appends numbers to a .bin file; the header is finalized in close()
+class CandidateWriter {
+public:
+    ~CandidateWriter();
+    bool open(const std::string& path);
+    bool write(const mpz_class& n);
+    bool close();
+
+private:
+    FILE* fp = nullptr;
+    CandidateHeader header = {};
+    uint64_t* limbBuf = nullptr;
+    size_t limbCap = 0;
+};
+
+// Zero-copy reader: maps the whole file and walks the records in place
+class CandidateReader {
+public:
+    ~CandidateReader();
+    bool open(const std::string& path);
+    void close();
+
+    // Fills n with the next record; false at end of file
+    bool next(mpz_t n);
+
+    uint64_t count() const { return header ? header->count : 0; }
+    uint64_t maxLimbs() const { return header ? header->maxLimbs : 0; }
+
+    // True if the file starts with the binary magic (vs. decimal text)
+    static bool isBinary(const std::string& path);
+
+private:
+    const unsigned char* base = nullptr;
+    size_t size = 0;
+    size_t offset = 0;
+    const CandidateHeader* header = nullptr;
+};
+
+// Converts a text file (one decimal number per line) to the binary format
+bool convertTextToBinary(const std::string& textPath, const std::string& binPath);
+
+#endif
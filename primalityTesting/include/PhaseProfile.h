@@ -0,0 +1,52 @@
+#ifndef PHASE_PROFILE_H
+#define PHASE_PROFILE_H
+
+#include <chrono>
+#include <cstdint>
+
+// Where the time goes for one number (enabled with --profile).
+// main.cpp owns one of these and hands it to the tester with
+// setProfile(); the testers only touch it when it is set, so the
+// default build and default runs pay one null check per round.
+//
+// Times are in nanoseconds from steady_clock. The witness loop charges
+// each step to the phase that just ended, so for one test
+// Witness + Powm + Squaring add up to the loop's wall time.
+class PhaseProfile {
+public:
+    enum Phase {
+        Parse,     // decimal text (or binary record) -> mpz
+        Seed,      // gmp_randseed_ui, once per run
+        Witness,   // nextWitness(): urandomm or the fixed schedule
+        Powm,      // a^d mod n (Fermat: a^(n-1) mod n)
+        Squaring,  // Miller-Rabin x = x^2 mod n chain
+        Output,    // number -> truncated decimal for the CSV row
+        NUM_PHASES
+    };
+
+    static const char* phaseName(int p);
+
+    static uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Charges the time since 'since' to phase p and moves 'since' to now
+    void charge(Phase p, uint64_t& since) {
+        uint64_t t = now();
+        ns[p] += t - since;
+        since = t;
+    }
+
+    // Zero everything (main.cpp does this before each number)
+    void clear();
+
+    // Add another profile's times and counts into this one (run totals)
+    void merge(const PhaseProfile& o);
+
+    uint64_t ns[NUM_PHASES] = {};
+    uint64_t rounds = 0;     // witness rounds started
+    uint64_t squarings = 0;  // Miller-Rabin squarings, all rounds
+};
+
+#endif
@@ -3,12 +3,32 @@
 
 #include <gmpxx.h>
 #include <string>
+#include "Workspace.h"
+#include "PhaseProfile.h"
+
+// How the witnesses (bases 'a') are chosen on each round
+enum class WitnessMode {
+    Random, // uniform in [2, n-2] from the tester's seeded generator
+    Fixed   // the first k primes 2, 3, 5, 7, ... (same bases for every n)
+};
 
 // Abstract Base Class
 class PrimalityTester {
 public:
+    // Seeds the generator once from std::random_device (see seed())
+    PrimalityTester();
     virtual ~PrimalityTester() {}
 
+    // Reseed the witness generator. Called once per tester (i.e. per thread),
+    // never per number, so a batch gets one continuous, replayable stream.
+    void seed(unsigned long s);
+
+    void setWitnessMode(WitnessMode mode) { witnessMode = mode; }
+
+    // Per-phase timers and round/squaring counts go into 'p' (nullptr: off).
+    // The tester only adds to it; clearing between numbers is up to the caller.
+    void setProfile(PhaseProfile* p) { profile = p; }
+
     // Pure virtual function: subclasses MUST implement this
     // n: the number to test
     // k: the number of iterations (accuracy parameter)
@@ -16,6 +36,15 @@ public:
 
     // Helper to get the name of the algorithm (useful for CSV output)
     virtual std::string name() const = 0;
+
+protected:
+    // Writes the witness for round i into ws.a (needs ws.prepare(n) first)
+    void nextWitness(int i);
+
+    // Reusable mpz buffers for the witness loop (one per tester instance)
+    Workspace ws;
+    WitnessMode witnessMode = WitnessMode::Random;
+    PhaseProfile* profile = nullptr;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef PRIME_GENERATOR_H
+#define PRIME_GENERATOR_H
+
+#include <gmpxx.h>
+#include <vector>
+
+// Sieve-then-test generator for random k-bit primes.
+//
+// Each search picks a random odd k-bit start, sieves a window of odd offsets
+// against a table of small primes, and only runs Miller-Rabin on the
+// survivors. If a window has no prime, the residues are shifted to the next
+// window instead of being recomputed (incremental sieve).
+class PrimeGenerator {
+public:
+    // bits: size of the primes, k: Miller-Rabin rounds per survivor
+    PrimeGenerator(int bits, int k);
+
+    // Generates 'count' primes using 'threads' workers. Worker t is seeded
+    // with seed + t and produces a fixed share, so the output only depends
+    // on (seed, threads).
+    std::vector<mpz_class> generate(size_t count, int threads, unsigned long seed);
+
+    // Survivors handed to Miller-Rabin during the last generate() call
+    unsigned long long testedCandidates() const { return tested; }
+
+private:
+    int bits;
+    int k;
+    unsigned long long tested = 0;
+};
+
+#endif
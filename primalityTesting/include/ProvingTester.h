@@ -0,0 +1,42 @@
+#ifndef PROVING_TESTER_H
+#define PROVING_TESTER_H
+
+#include <memory>
+#include "PrimalityTester.h"
+#include "SpecialForm.h"
+
+// Dispatch in front of another tester (enabled with --prove).
+// Candidates of a special form (see SpecialForm.h) get a deterministic
+// proof; everything else, and any proof that runs out of bases, goes to
+// the wrapped tester as before. Seed and configure the wrapped tester
+// before handing it over.
+class ProvingTester : public PrimalityTester {
+public:
+    explicit ProvingTester(std::unique_ptr<PrimalityTester> fallback);
+
+    bool test(const mpz_class& n, int k) override;
+    std::string name() const override { return "Proving+" + fallback->name(); }
+
+    // Build prime certificates (off by default: they cost a decimal
+    // conversion of n inside the timed test)
+    void setCertificates(bool on) { wantCertificates = on; }
+
+    // Form proven by the last test(), None if it fell back
+    NumberForm lastProof() const { return proof; }
+
+    // Certificate of the last test() when it proved a prime, else empty
+    const std::string& lastCertificate() const { return certificate; }
+
+    // Numbers settled by each form (indexed by NumberForm; None = fallback)
+    unsigned long long settled(NumberForm form) const { return counts[(int)form]; }
+
+private:
+    std::unique_ptr<PrimalityTester> fallback;
+    SpecialFormProver prover;
+    NumberForm proof = NumberForm::None;
+    std::string certificate;
+    bool wantCertificates = false;
+    unsigned long long counts[4] = {};
+};
+
+#endif
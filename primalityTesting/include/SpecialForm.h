@@ -0,0 +1,81 @@
+#ifndef SPECIAL_FORM_H
+#define SPECIAL_FORM_H
+
+#include <gmpxx.h>
+#include <string>
+#include <vector>
+
+// Deterministic proofs for candidates with exploitable structure.
+//
+//   Mersenne     n = 2^p - 1          Lucas-Lehmer, p-2 squarings with
+//                                     shift-and-add reduction mod 2^p - 1
+//   Proth        n = k*2^m + 1,       one a^((n-1)/2) mod n for a quadratic
+//                k odd, k < 2^m       non-residue a (Proth's theorem)
+//   Pocklington  n - 1 = F*R with F   one exponentiation per prime q | F
+//                fully factored,      (Pocklington-Lehmer)
+//                F^2 > n
+//
+// F is the part of n-1 found by trial division up to TRIAL_BOUND (a cofactor
+// R < TRIAL_BOUND^2 with no small factor is prime and joins F). Anything
+// else, or a form whose bases run out, is Unknown and left to the
+// probabilistic testers.
+
+enum class NumberForm { None, Mersenne, Proth, Pocklington };
+
+enum class ProofResult { Unknown, Prime, Composite };
+
+const char* formName(NumberForm form);
+
+// What detectForm() found; only the fields of 'form' are filled in
+struct FormInfo {
+    NumberForm form = NumberForm::None;
+    unsigned long exponent = 0;           // Mersenne p, Proth m
+    mpz_class multiplier;                 // Proth k
+    mpz_class F, R;                       // Pocklington n-1 = F*R
+    std::vector<unsigned long> primes;    // distinct primes of F
+    std::vector<unsigned long> powers;    // their exponents in F
+};
+
+// Cheapest applicable form first: Mersenne, Proth, then Pocklington
+FormInfo detectForm(const mpz_class& n);
+
+// Prime certificates, plain text, one per proven prime:
+//
+//   PRIME <n>
+//   METHOD lucas-lehmer | proth | pocklington
+//   P <p>                      lucas-lehmer: n = 2^p - 1, s_(p-2) = 0
+//   K <k> M <m> A <a>          proth: n = k*2^m + 1, a^((n-1)/2) = -1 mod n
+//   F <F> R <R>                pocklington: n - 1 = F*R, F^2 > n
+//   FACTOR <q> <e> <a>         one per prime q^e || F: a^(n-1) = 1 and
+//                              gcd(a^((n-1)/q) - 1, n) = 1
+//   END
+class SpecialFormProver {
+public:
+    SpecialFormProver();
+    ~SpecialFormProver();
+
+    SpecialFormProver(const SpecialFormProver&) = delete;
+    SpecialFormProver& operator=(const SpecialFormProver&) = delete;
+
+    // Detects the form of n and runs its proof. On Prime, 'certificate'
+    // (if given) receives the certificate above; it is left alone otherwise.
+    ProofResult prove(const mpz_class& n, std::string* certificate = nullptr);
+
+    // Form used by the last prove() call (None if nothing applied)
+    NumberForm lastForm() const { return form; }
+
+    // Small primes used for trial division of n-1 and for the bases
+    static const unsigned long TRIAL_BOUND = 1 << 12;
+
+private:
+    ProofResult lucasLehmer(const mpz_class& n, const FormInfo& info, std::string* certificate);
+    ProofResult proth(const mpz_class& n, const FormInfo& info, std::string* certificate);
+    ProofResult pocklington(const mpz_class& n, const FormInfo& info, std::string* certificate);
+
+    NumberForm form = NumberForm::None;
+
+    // Scratch, sized by GMP on first use and reused across numbers
+    mpz_t s, sq, hi, e, y, g;
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include <gmpxx.h>
+#include <cstddef>
+
+// Scratch space for the witness loop.
+// Every tester owns one of these (so one per thread), and the buffers are
+// sized once per candidate instead of being malloc'd/freed on every round.
+class Workspace {
+public:
+    Workspace();
+    ~Workspace();
+
+    // Not copyable: it owns raw mpz_t limb arrays
+    Workspace(const Workspace&) = delete;
+    Workspace& operator=(const Workspace&) = delete;
+
+    // Grow the buffers (if needed) to fit n and precompute n-1, n-4
+    void prepare(const mpz_class& n);
+
+    mpz_t a;        // current witness
+    mpz_t x;        // a^d mod n, then the squaring chain
+    mpz_t sq;       // x^2 before reduction (twice the size of n)
+    mpz_t d;        // odd part of n-1
+    mpz_t nMinus1;  // n-1, compared against on every squaring
+    mpz_t nMinus4;  // range for the witness: a = urandomm(n-4) + 2
+
+    gmp_randstate_t rng;
+
+private:
+    size_t capacityBits;
+};
+
+#endif
@@ -34,6 +34,28 @@ def generate_composites(bits, count):
         composites.add(comp)
     return list(composites)
 
+def generate_special_forms(count):
+    """Numbers the --prove dispatch can settle deterministically:
+    Mersenne 2^p-1, Proth k*2^m+1 (k odd, k < 2^m) and Pocklington
+    candidates whose n-1 is smooth. Primes and composites mixed."""
+    print(f"[*] Generating {count} numbers per special form...")
+    numbers = [2**p - 1 for p in sympy.primerange(3, 1300)][:count]
+    small = list(sympy.primerange(3, 4096))
+    proth, pocklington = [], []
+    while len(proth) < count:
+        m = random.randint(64, 1024)
+        k = random.randrange(1, 2**min(m - 1, 64), 2)
+        proth.append(k * 2**m + 1)
+    while len(pocklington) < count:
+        # n-1 = 2 * (product of primes < 4096), about half of them prime
+        f = 2
+        target = random.choice(BIT_LENGTHS)
+        while f.bit_length() < target:
+            f *= random.choice(small)
+        if len(pocklington) % 2 == 0 or sympy.isprime(f + 1):
+            pocklington.append(f + 1)
+    return numbers + proth + pocklington
+
 def save_to_file(filename, numbers):
     filepath = os.path.join(DATA_DIR, filename)
     with open(filepath, "w") as f:
@@ -61,6 +83,9 @@ def main():
     print(f"[*] Saving {len(carmichaels)} Carmichael Numbers...")
     save_to_file("carmichael.txt", carmichaels)
 
+    # 3. Special Forms (for --prove)
+    save_to_file("special_forms.txt", generate_special_forms(SAMPLES_PER_BATCH))
+
     print("\n--- Data Generation Complete ---")
 
 if __name__ == "__main__":
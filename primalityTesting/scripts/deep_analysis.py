@@ -6,6 +6,11 @@ import matplotlib.pyplot as plt
 import seaborn as sns
 import numpy as np
 import re
+import sys
+
+# CSV or the typed .col files written by common/result_sink.h
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "common"))
+from result_sink import read_results
 
 # --- CONFIGURATION ---
 BIN_PATH = "../bin/primality_test"
@@ -43,7 +48,7 @@ def plot_runtime_scalability():
         print("   [!] results.csv not found. Please run benchmark_runner.py first for this specific plot.")
         return
 
-    df = pd.read_csv(RESULTS_FILE)
+    df = read_results(RESULTS_FILE)
 
     df = df[
         (~df['File'].str.contains("carmichael")) & 
@@ -0,0 +1,348 @@
+#include "../include/BatchMillerRabin.h"
+#include <algorithm>
+#include <map>
+#include <immintrin.h>
+
+typedef unsigned __int128 u128;
+
+static const int W = BatchMillerRabin::LANES;
+static const uint64_t MASK52 = (1ULL << 52) - 1;
+
+// Fixed-window exponentiation: 4 exponent bits per table lookup
+static const int WINDOW_BITS = 4;
+static const int TABLE_SIZE = 1 << WINDOW_BITS;
+
+// 52-bit limbs needed for an n of 'bits' bits. Two spare bits keep 4N < R,
+// so Montgomery products of inputs below 2N stay below 2N without a final
+// subtraction in the hot loop.
+static int limbsFor(size_t bits) {
+    return (int)((bits + 2 + 51) / 52);
+}
+
+// ------------------------------------------------------------
+// Montgomery multiplication kernels
+// out = a * b * R^-1 (mod N) for all LANES at once, R = 2^(52L).
+// Inputs must be normalized (every limb < 2^52) and below 2N; the output
+// is normalized and below 2N. out may alias a or b. T holds (L+1)*W words.
+//
+// The accumulators are left unnormalized between rows (each gains at most
+// four 52-bit terms per row), which fits in 64 bits for L up to ~2^10.
+// ------------------------------------------------------------
+static void montMulScalar(uint64_t* out, const uint64_t* A, const uint64_t* B,
+                          const uint64_t* N, const uint64_t* n0inv, int L, uint64_t* T) {
+    std::fill(T, T + (L + 1) * W, 0);
+
+    for (int i = 0; i < L; i++) {
+        const uint64_t* b = B + i * W;
+
+        // T += A * b[i]
+        for (int j = 0; j < L; j++) {
+            for (int l = 0; l < W; l++) {
+                u128 p = (u128)A[j * W + l] * b[l];
+                T[j * W + l] += (uint64_t)p & MASK52;
+                T[(j + 1) * W + l] += (uint64_t)(p >> 52);
+            }
+        }
+
+        // m = T[0] * (-N^-1) mod 2^52, so that T + m*N is divisible by 2^52
+        uint64_t m[W];
+        for (int l = 0; l < W; l++) m[l] = ((T[l] & MASK52) * n0inv[l]) & MASK52;
+
+        for (int j = 0; j < L; j++) {
+            for (int l = 0; l < W; l++) {
+                u128 p = (u128)N[j * W + l] * m[l];
+                T[j * W + l] += (uint64_t)p & MASK52;
+                T[(j + 1) * W + l] += (uint64_t)(p >> 52);
+            }
+        }
+
+        // Drop the (now zero) low limb, carrying its overflow into the next one
+        uint64_t carry[W];
+        for (int l = 0; l < W; l++) carry[l] = T[l] >> 52;
+        std::copy(T + W, T + (L + 1) * W, T);
+        for (int l = 0; l < W; l++) {
+            T[L * W + l] = 0;
+            T[l] += carry[l];
+        }
+    }
+
+    for (int l = 0; l < W; l++) {
+        uint64_t c = 0;
+        for (int j = 0; j < L; j++) {
+            uint64_t v = T[j * W + l] + c;
+            out[j * W + l] = v & MASK52;
+            c = v >> 52;
+        }
+    }
+}
+
+__attribute__((target("avx512f,avx512ifma")))
+static void montMulIFMA(uint64_t* out, const uint64_t* A, const uint64_t* B,
+                        const uint64_t* N, const uint64_t* n0inv, int L, uint64_t* T) {
+    const __m512i mask = _mm512_set1_epi64(MASK52);
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i k0 = _mm512_loadu_si512(n0inv);
+
+    for (int j = 0; j <= L; j++) _mm512_storeu_si512(T + j * W, zero);
+
+    for (int i = 0; i < L; i++) {
+        const __m512i b = _mm512_loadu_si512(B + i * W);
+
+        // T += A * b[i]: limb j takes lo(A[j]*b) and hi(A[j-1]*b)
+        __m512i prev = zero;
+        for (int j = 0; j <= L; j++) {
+            __m512i t = _mm512_loadu_si512(T + j * W);
+            __m512i a = zero;
+            if (j < L) {
+                a = _mm512_loadu_si512(A + j * W);
+                t = _mm512_madd52lo_epu64(t, a, b);
+            }
+            if (j > 0) t = _mm512_madd52hi_epu64(t, prev, b);
+            _mm512_storeu_si512(T + j * W, t);
+            prev = a;
+        }
+
+        // m = T[0] * (-N^-1) mod 2^52
+        __m512i t0 = _mm512_loadu_si512(T);
+        const __m512i m = _mm512_madd52lo_epu64(zero, _mm512_and_si512(t0, mask), k0);
+
+        // T = (T + m*N) / 2^52, fused with the one-limb shift
+        __m512i n = _mm512_loadu_si512(N);
+        t0 = _mm512_madd52lo_epu64(t0, n, m);
+        __m512i carry = _mm512_maskz_srli_epi64(0xFF, t0, 52);
+        for (int j = 1; j <= L; j++) {
+            __m512i t = _mm512_loadu_si512(T + j * W);
+            __m512i next = zero;
+            if (j < L) {
+                next = _mm512_loadu_si512(N + j * W);
+                t = _mm512_madd52lo_epu64(t, next, m);
+            }
+            t = _mm512_madd52hi_epu64(t, n, m);
+            if (j == 1) t = _mm512_add_epi64(t, carry);
+            _mm512_storeu_si512(T + (j - 1) * W, t);
+            n = next;
+        }
+        _mm512_storeu_si512(T + L * W, zero);
+    }
+
+    // Carry propagation runs limb by limb, but across all lanes at once
+    __m512i c = zero;
+    for (int j = 0; j < L; j++) {
+        __m512i v = _mm512_add_epi64(_mm512_loadu_si512(T + j * W), c);
+        _mm512_storeu_si512(out + j * W, _mm512_and_si512(v, mask));
+        c = _mm512_maskz_srli_epi64(0xFF, v, 52);
+    }
+}
+
+static bool cpuHasIfma() {
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma");
+}
+
+// ------------------------------------------------------------
+// Lane helpers (radix 2^52, element [j * W + lane])
+// ------------------------------------------------------------
+
+// Writes x (which must be below 2^(52L)) into one lane of dst
+static void toLimbs52(const mpz_class& x, int L, int lane, uint64_t* dst) {
+    std::vector<uint64_t> words((52 * L + 63) / 64 + 1, 0);
+    size_t count = 0;
+    mpz_export(words.data(), &count, -1, sizeof(uint64_t), 0, 0, x.get_mpz_t());
+
+    for (int j = 0; j < L; j++) {
+        int bit = 52 * j;
+        int w = bit / 64, off = bit % 64;
+        uint64_t v = words[w] >> off;
+        if (off > 12) v |= words[w + 1] << (64 - off);
+        dst[j * W + lane] = v & MASK52;
+    }
+}
+
+// Brings a lane from [0, 2N) down to [0, N)
+static void reduceLane(uint64_t* x, const uint64_t* N, int L, int lane) {
+    for (int j = L - 1; j >= 0; j--) {
+        uint64_t a = x[j * W + lane], n = N[j * W + lane];
+        if (a < n) return;
+        if (a > n) break;
+    }
+    uint64_t borrow = 0;
+    for (int j = 0; j < L; j++) {
+        uint64_t v = x[j * W + lane] - N[j * W + lane] - borrow;
+        borrow = v >> 63;
+        x[j * W + lane] = v & MASK52;
+    }
+}
+
+static bool laneEquals(const uint64_t* x, const uint64_t* y, int L, int lane) {
+    for (int j = 0; j < L; j++) {
+        if (x[j * W + lane] != y[j * W + lane]) return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// BatchMillerRabin
+// ------------------------------------------------------------
+BatchMillerRabin::BatchMillerRabin() : simd(cpuHasIfma()) {}
+
+void BatchMillerRabin::setScalarKernel(bool scalar) {
+    simd = !scalar && cpuHasIfma();
+}
+
+void BatchMillerRabin::montMul(uint64_t* out, const uint64_t* a, const uint64_t* b) {
+    if (simd) montMulIFMA(out, a, b, N.data(), n0inv.data(), L, T.data());
+    else montMulScalar(out, a, b, N.data(), n0inv.data(), L, T.data());
+}
+
+bool BatchMillerRabin::test(const mpz_class& n, int k) {
+    return testBatch(std::vector<mpz_class>(1, n), k)[0] != 0;
+}
+
+std::vector<char> BatchMillerRabin::testBatch(const std::vector<mpz_class>& ns, int k) {
+    std::vector<char> result(ns.size(), 0);
+
+    // Same base cases as MillerRabin; everything else is grouped by limb count
+    std::map<int, std::vector<size_t>> groups;
+    for (size_t i = 0; i < ns.size(); i++) {
+        const mpz_class& n = ns[i];
+        if (n <= 1) result[i] = 0;
+        else if (n <= 3) result[i] = 1;
+        else if (mpz_even_p(n.get_mpz_t())) result[i] = 0;
+        else groups[limbsFor(mpz_sizeinbase(n.get_mpz_t(), 2))].push_back(i);
+    }
+
+    for (const auto& g : groups) {
+        const std::vector<size_t>& idx = g.second;
+        for (size_t start = 0; start < idx.size(); start += LANES) {
+            int count = (int)std::min<size_t>(LANES, idx.size() - start);
+            const mpz_class* lane[LANES];
+            char laneResult[LANES];
+            for (int l = 0; l < count; l++) lane[l] = &ns[idx[start + l]];
+
+            testGroup(lane, count, g.first, k, laneResult);
+            for (int l = 0; l < count; l++) result[idx[start + l]] = laneResult[l];
+        }
+    }
+    return result;
+}
+
+void BatchMillerRabin::testGroup(const mpz_class* const* ns, int count, int limbs, int k, char* out) {
+    L = limbs;
+    N.assign(L * W, 0);
+    n0inv.assign(W, 0);
+    one.assign(L * W, 0);
+    minusOne.assign(L * W, 0);
+    T.assign((L + 1) * W, 0);
+    lanesTested += count;
+
+    mpz_class R = 0;
+    mpz_setbit(R.get_mpz_t(), 52 * L);
+
+    // Per-lane constants. Unused lanes repeat the last real candidate.
+    mpz_class d[W];
+    long r[W];
+    size_t maxBits = 0;
+    for (int l = 0; l < W; l++) {
+        const mpz_class& n = *ns[std::min(l, count - 1)];
+        toLimbs52(n, L, l, N.data());
+
+        // -N^-1 mod 2^52 by Newton iteration (each step doubles the correct bits)
+        uint64_t n0 = N[l], inv = n0;
+        for (int it = 0; it < 5; it++) inv *= 2 - n0 * inv;
+        n0inv[l] = (0 - inv) & MASK52;
+
+        // Montgomery forms of 1 and n-1
+        mpz_class rModN = R % n;
+        mpz_class nMinusR = n - rModN;
+        toLimbs52(rModN, L, l, one.data());
+        toLimbs52(nMinusR, L, l, minusOne.data());
+
+        // n-1 = d * 2^r
+        mpz_class nm1 = n - 1;
+        r[l] = (long)mpz_scan1(nm1.get_mpz_t(), 0);
+        mpz_tdiv_q_2exp(d[l].get_mpz_t(), nm1.get_mpz_t(), r[l]);
+        maxBits = std::max(maxBits, mpz_sizeinbase(d[l].get_mpz_t(), 2));
+    }
+
+    bool composite[W];
+    for (int l = 0; l < W; l++) composite[l] = (l >= count); // padding never counts
+
+    std::vector<uint64_t> table(TABLE_SIZE * L * W), x(L * W), op(L * W);
+    mpz_class aR;
+    const int windows = (int)((maxBits + WINDOW_BITS - 1) / WINDOW_BITS);
+
+    for (int i = 0; i < k; i++) {
+        if (std::all_of(composite, composite + W, [](bool c) { return c; })) break;
+
+        // Witness per lane, from the same schedule as the scalar testers
+        uint64_t* base = table.data() + L * W;
+        for (int l = 0; l < W; l++) {
+            const mpz_class& n = *ns[std::min(l, count - 1)];
+            if (l < count) { // padding lanes reuse the last real witness
+                ws.prepare(n);
+                nextWitness(i);
+            }
+            mpz_mul_2exp(aR.get_mpz_t(), ws.a, 52 * L);
+            mpz_mod(aR.get_mpz_t(), aR.get_mpz_t(), n.get_mpz_t());
+            toLimbs52(aR, L, l, base);
+        }
+
+        // table[w] = a^w in Montgomery form
+        std::copy(one.begin(), one.end(), table.begin());
+        for (int w = 2; w < TABLE_SIZE; w++) {
+            montMul(table.data() + w * L * W, table.data() + (w - 1) * L * W, base);
+        }
+
+        // x = a^d, all lanes in lockstep over the longest d. Shorter exponents
+        // just read zero windows (multiply by 1) at the top.
+        std::copy(one.begin(), one.end(), x.begin());
+        for (int win = windows - 1; win >= 0; win--) {
+            if (win != windows - 1) {
+                for (int s = 0; s < WINDOW_BITS; s++) montMul(x.data(), x.data(), x.data());
+            }
+            for (int l = 0; l < W; l++) {
+                int w = 0;
+                for (int b = WINDOW_BITS - 1; b >= 0; b--) {
+                    w = (w << 1) | mpz_tstbit(d[l].get_mpz_t(), win * WINDOW_BITS + b);
+                }
+                const uint64_t* src = table.data() + w * L * W;
+                for (int j = 0; j < L; j++) op[j * W + l] = src[j * W + l];
+            }
+            montMul(x.data(), x.data(), op.data());
+        }
+
+        // Case 1: x is 1 or n-1 -> this round passes
+        bool pending[W];
+        long maxR = 0;
+        for (int l = 0; l < W; l++) {
+            pending[l] = false;
+            if (composite[l]) continue;
+            reduceLane(x.data(), N.data(), L, l);
+            if (laneEquals(x.data(), one.data(), L, l) || laneEquals(x.data(), minusOne.data(), L, l)) continue;
+            pending[l] = true;
+            maxR = std::max(maxR, r[l]);
+        }
+
+        // Case 2: square up to r-1 times looking for n-1
+        for (long s = 1; s < maxR; s++) {
+            if (std::none_of(pending, pending + W, [](bool p) { return p; })) break;
+            montMul(x.data(), x.data(), x.data());
+            for (int l = 0; l < W; l++) {
+                if (!pending[l]) continue;
+                if (s > r[l] - 1) {
+                    composite[l] = true;
+                    pending[l] = false;
+                    continue;
+                }
+                reduceLane(x.data(), N.data(), L, l);
+                if (laneEquals(x.data(), minusOne.data(), L, l)) pending[l] = false;
+            }
+        }
+
+        // Never hit n-1 -> composite
+        for (int l = 0; l < W; l++) {
+            if (pending[l]) composite[l] = true;
+        }
+    }
+
+    for (int l = 0; l < count; l++) out[l] = composite[l] ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+#include "../include/CandidateFile.h"
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char CANDIDATE_MAGIC[8] = {'P', 'R', 'I', 'M', 'B', 'I', 'N', '1'};
+static const uint32_t CANDIDATE_VERSION = 1;
+
+// ------------------------------------------------------------
+// Writer
+// ------------------------------------------------------------
+CandidateWriter::~CandidateWriter() {
+    close();
+}
+
+bool CandidateWriter::open(const std::string& path) {
+    fp = std::fopen(path.c_str(), "wb");
+    if (!fp) return false;
+
+    std::memcpy(header.magic, CANDIDATE_MAGIC, sizeof(header.magic));
+    header.version = CANDIDATE_VERSION;
+    header.limbBytes = sizeof(uint64_t);
+    header.count = 0;
+    header.maxLimbs = 0;
+
+    // Placeholder header, rewritten with the real counts in close()
+    return std::fwrite(&header, sizeof(header), 1, fp) == 1;
+}
+
+bool CandidateWriter::write(const mpz_class& n) {
+    if (!fp) return false;
+
+    size_t limbs = (mpz_sizeinbase(n.get_mpz_t(), 2) + 63) / 64;
+    if (limbs > limbCap) {
+        std::free(limbBuf);
+        limbBuf = static_cast<uint64_t*>(std::malloc(limbs * sizeof(uint64_t)));
+        limbCap = limbs;
+    }
+
+    size_t written = 0;
+    mpz_export(limbBuf, &written, -1, sizeof(uint64_t), -1, 0, n.get_mpz_t());
+
+    uint64_t len = written;
+    if (std::fwrite(&len, sizeof(len), 1, fp) != 1) return false;
+    if (written && std::fwrite(limbBuf, sizeof(uint64_t), written, fp) != written) return false;
+
+    header.count++;
+    if (len > header.maxLimbs) header.maxLimbs = len;
+    return true;
+}
+
+bool CandidateWriter::close() {
+    bool ok = true;
+    if (fp) {
+        ok = std::fseek(fp, 0, SEEK_SET) == 0
+          && std::fwrite(&header, sizeof(header), 1, fp) == 1;
+        ok = (std::fclose(fp) == 0) && ok;
+        fp = nullptr;
+    }
+    std::free(limbBuf);
+    limbBuf = nullptr;
+    limbCap = 0;
+    return ok;
+}
+
+// ------------------------------------------------------------
+// Reader
+// ------------------------------------------------------------
+CandidateReader::~CandidateReader() {
+    close();
+}
+
+bool CandidateReader::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(CandidateHeader)) {
+        ::close(fd);
+        return false;
+    }
+
+    void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps the file alive
+    if (p == MAP_FAILED) return false;
+
+    // We only ever walk forward through the file
+    madvise(p, st.st_size, MADV_SEQUENTIAL);
+
+    base = static_cast<const unsigned char*>(p);
+    size = st.st_size;
+    header = reinterpret_cast<const CandidateHeader*>(base);
+    offset = sizeof(CandidateHeader);
+
+    if (std::memcmp(header->magic, CANDIDATE_MAGIC, sizeof(CANDIDATE_MAGIC)) != 0
+        || header->version != CANDIDATE_VERSION
+        || header->limbBytes != sizeof(uint64_t)) {
+        std::cerr << "Error: " << path << " is not a version "
+                  << CANDIDATE_VERSION << " candidate file" << std::endl;
+        close();
+        return false;
+    }
+
+    // Every record is a length word plus its limbs, so neither the count
+    // nor the largest record can exceed the words after the header.
+    // maxLimbs pre-sizes the caller's buffer: trusting a corrupt value
+    // would ask GMP for an allocation it aborts on.
+    uint64_t words = (size - sizeof(CandidateHeader)) / sizeof(uint64_t);
+    if (header->count > words || (header->maxLimbs > 0 && header->maxLimbs >= words)) {
+        std::cerr << "Error: " << path << " has a corrupt header (count "
+                  << header->count << ", maxLimbs " << header->maxLimbs
+                  << ", " << size << " bytes)" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void CandidateReader::close() {
+    if (base) munmap(const_cast<unsigned char*>(base), size);
+    base = nullptr;
+    header = nullptr;
+    size = 0;
+    offset = 0;
+}
+
+bool CandidateReader::next(mpz_t n) {
+    if (!base || offset + sizeof(uint64_t) > size) return false;
+
+    uint64_t limbs;
+    std::memcpy(&limbs, base + offset, sizeof(limbs));
+    offset += sizeof(limbs);
+
+    if (limbs > (size - offset) / sizeof(uint64_t)) {
+        std::cerr << "Error: truncated candidate record" << std::endl;
+        offset = size;
+        return false;
+    }
+
+    // Limbs come straight out of the mapping: no text parsing, no copies
+    mpz_import(n, limbs, -1, sizeof(uint64_t), -1, 0, base + offset);
+    offset += limbs * sizeof(uint64_t);
+    return true;
+}
+
+bool CandidateReader::isBinary(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(CANDIDATE_MAGIC)] = {};
+    in.read(magic, sizeof(magic));
+    return in.gcount() == (std::streamsize)sizeof(magic)
+        && std::memcmp(magic, CANDIDATE_MAGIC, sizeof(magic)) == 0;
+}
+
+// ------------------------------------------------------------
+// Converter
+// ------------------------------------------------------------
+bool convertTextToBinary(const std::string& textPath, const std::string& binPath) {
+    std::ifstream infile(textPath);
+    if (!infile.is_open()) {
+        std::cerr << "Error: Could not open file " << textPath << std::endl;
+        return false;
+    }
+
+    CandidateWriter writer;
+    if (!writer.open(binPath)) {
+        std::cerr << "Error: Could not create file " << binPath << std::endl;
+        return false;
+    }
+
+    std::string line;
+    mpz_class n;
+    while (std::getline(infile, line)) {
+        if (line.empty()) continue;
+        if (n.set_str(line, 10) != 0) {
+            std::cerr << "Error: not a decimal number: " << line << std::endl;
+            return false;
+        }
+        if (!writer.write(n)) {
+            std::cerr << "Error: write failed on " << binPath << std::endl;
+            return false;
+        }
+    }
+    return writer.close();
+}
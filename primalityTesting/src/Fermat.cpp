@@ -1,35 +1,35 @@
 #include "../include/Fermat.h"
 #include <iostream>
 
-// Initialize the random number generator
-gmp_randclass rng(gmp_randinit_default);
-
 bool Fermat::test(const mpz_class& n, int k) {
     // 1. Edge Cases
     if (n <= 1) return false;
     if (n <= 3) return true;
-    if (n % 2 == 0) return false; 
+    if (mpz_even_p(n.get_mpz_t())) return false;
 
-    rng.seed(time(NULL));
+    // Size the scratch buffers once and precompute n-1 and n-4
+    ws.prepare(n);
 
     // 2. The Main Loop
+    PhaseProfile* prof = profile;
+    uint64_t t = prof ? PhaseProfile::now() : 0;
     for (int i = 0; i < k; i++) {
-        // Pick a random base 'a' in range [2, n-2]
-        mpz_class a = rng.get_z_range(n - 4) + 2;
+        // Pick base 'a' in range [2, n-2] (random or fixed schedule)
+        nextWitness(i);
+        if (prof) {
+            prof->charge(PhaseProfile::Witness, t);
+            prof->rounds++;
+        }
 
-        // --- THE FIX IS HERE ---
-        // We create a named variable 'exponent' to hold (n - 1)
-        mpz_class exponent = n - 1; 
-        mpz_class result;
-        
-        // Now we can safely call .get_mpz_t() on 'exponent'
-        mpz_powm(result.get_mpz_t(), a.get_mpz_t(), exponent.get_mpz_t(), n.get_mpz_t());
+        // x = a^(n-1) mod n, written straight into the preallocated buffer
+        mpz_powm(ws.x, ws.a, ws.nMinus1, n.get_mpz_t());
+        if (prof) prof->charge(PhaseProfile::Powm, t);
 
         // Check Fermat's condition
-        if (result != 1) {
+        if (mpz_cmp_ui(ws.x, 1) != 0) {
             return false;
         }
     }
 
     return true;
-}
\ No newline at end of file
+}
@@ -1,49 +1,59 @@
 #include "../include/MillerRabin.h"
 #include <iostream>
 
-gmp_randclass rng_mr(gmp_randinit_default);
-
 bool MillerRabin::test(const mpz_class& n, int k) {
     // 1. Handle base cases
     if (n <= 1) return false;
     if (n <= 3) return true;
-    if (n % 2 == 0) return false;
+    if (mpz_even_p(n.get_mpz_t())) return false;
 
-    rng_mr.seed(time(NULL));
+    // Size the scratch buffers once and precompute n-1 and n-4
+    ws.prepare(n);
+    const mpz_srcptr N = n.get_mpz_t();
 
     // 2. Find d and r such that n-1 = d * 2^r
-    // We basically divide (n-1) by 2 until we can't anymore.
-    mpz_class d = n - 1;
-    long r = 0;
-    while (d % 2 == 0) {
-        d /= 2;
-        r++;
-    }
+    // r is the number of trailing zero bits of n-1, so we can shift instead of dividing.
+    long r = (long)mpz_scan1(ws.nMinus1, 0);
+    mpz_tdiv_q_2exp(ws.d, ws.nMinus1, r);
 
     // 3. The Witness Loop
+    // With a profile set, each step is charged to its phase as it ends
+    PhaseProfile* prof = profile;
+    uint64_t t = prof ? PhaseProfile::now() : 0;
     for (int i = 0; i < k; i++) {
-        // Pick random 'a' in [2, n-2]
-        mpz_class a = rng_mr.get_z_range(n - 4) + 2;
+        // Pick 'a' in [2, n-2] (random or fixed schedule)
+        nextWitness(i);
+        if (prof) {
+            prof->charge(PhaseProfile::Witness, t);
+            prof->rounds++;
+        }
 
         // Compute x = a^d % n
-        mpz_class x;
-        mpz_powm(x.get_mpz_t(), a.get_mpz_t(), d.get_mpz_t(), n.get_mpz_t());
+        mpz_powm(ws.x, ws.a, ws.d, N);
+        if (prof) prof->charge(PhaseProfile::Powm, t);
 
         // Case 1: If x is 1 or n-1, this iteration passes (continue to next random a)
-        if (x == 1 || x == n - 1) continue;
+        if (mpz_cmp_ui(ws.x, 1) == 0 || mpz_cmp(ws.x, ws.nMinus1) == 0) continue;
 
         // Case 2: Square 'x' repeatedly 'r-1' times
         bool composite = true;
-        for (int j = 0; j < r - 1; j++) {
-            // x = x^2 % n
-            mpz_powm_ui(x.get_mpz_t(), x.get_mpz_t(), 2, n.get_mpz_t());
+        long j = 0;
+        for (; j < r - 1; j++) {
+            // x = x^2 % n (square into the double-width buffer, then reduce)
+            mpz_mul(ws.sq, ws.x, ws.x);
+            mpz_mod(ws.x, ws.sq, N);
 
             // If we hit n-1, we are safe for this round
-            if (x == n - 1) {
+            if (mpz_cmp(ws.x, ws.nMinus1) == 0) {
                 composite = false;
+                j++;
                 break;
             }
         }
+        if (prof) {
+            prof->charge(PhaseProfile::Squaring, t);
+            prof->squarings += j;
+        }
 
         // If we never hit n-1, it's composite
         if (composite) return false;
@@ -51,4 +61,4 @@ bool MillerRabin::test(const mpz_class& n, int k) {
 
     // If we survived k rounds, it's very likely prime
     return true;
-}
\ No newline at end of file
+}
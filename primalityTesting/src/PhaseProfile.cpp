@@ -0,0 +1,20 @@
+#include "../include/PhaseProfile.h"
+
+const char* PhaseProfile::phaseName(int p) {
+    static const char* names[NUM_PHASES] = {
+        "Parse", "Seed", "Witness", "Powm", "Squaring", "Output"
+    };
+    return (p >= 0 && p < NUM_PHASES) ? names[p] : "?";
+}
+
+void PhaseProfile::clear() {
+    for (int p = 0; p < NUM_PHASES; p++) ns[p] = 0;
+    rounds = 0;
+    squarings = 0;
+}
+
+void PhaseProfile::merge(const PhaseProfile& o) {
+    for (int p = 0; p < NUM_PHASES; p++) ns[p] += o.ns[p];
+    rounds += o.rounds;
+    squarings += o.squarings;
+}
@@ -0,0 +1,44 @@
+#include "../include/PrimalityTester.h"
+#include <random>
+
+// Bases for WitnessMode::Fixed. Past the end of the table we keep stepping
+// through odd numbers, which is still deterministic.
+static const unsigned long SMALL_PRIMES[] = {
+      2,   3,   5,   7,  11,  13,  17,  19,  23,  29,  31,  37,  41,  43,  47,  53,
+     59,  61,  67,  71,  73,  79,  83,  89,  97, 101, 103, 107, 109, 113, 127, 131,
+    137, 139, 149, 151, 157, 163, 167, 173, 179, 181, 191, 193, 197, 199, 211, 223,
+    227, 229, 233, 239, 241, 251, 257, 263, 269, 271, 277, 281, 283, 293, 307, 311
+};
+static const int NUM_SMALL_PRIMES = sizeof(SMALL_PRIMES) / sizeof(SMALL_PRIMES[0]);
+
+PrimalityTester::PrimalityTester() {
+    std::random_device rd;
+    seed(((unsigned long)rd() << 32) ^ rd());
+}
+
+void PrimalityTester::seed(unsigned long s) {
+    uint64_t t = profile ? PhaseProfile::now() : 0;
+    gmp_randseed_ui(ws.rng, s);
+    if (profile) profile->charge(PhaseProfile::Seed, t);
+}
+
+void PrimalityTester::nextWitness(int i) {
+    if (witnessMode == WitnessMode::Random) {
+        // Uniform 'a' in [2, n-3] (urandomm gives [0, n-5])
+        mpz_urandomm(ws.a, ws.rng, ws.nMinus4);
+        mpz_add_ui(ws.a, ws.a, 2);
+        return;
+    }
+
+    unsigned long base = (i < NUM_SMALL_PRIMES)
+        ? SMALL_PRIMES[i]
+        : SMALL_PRIMES[NUM_SMALL_PRIMES - 1] + 2UL * (i - NUM_SMALL_PRIMES + 1);
+
+    // Tiny n: fold the base back into [2, n-3] so it stays a valid witness
+    mpz_set_ui(ws.a, base);
+    if (mpz_cmp(ws.a, ws.nMinus4) >= 0) {
+        mpz_set_ui(ws.a, base - 2);
+        mpz_mod(ws.a, ws.a, ws.nMinus4);
+        mpz_add_ui(ws.a, ws.a, 2);
+    }
+}
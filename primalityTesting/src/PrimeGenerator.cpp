@@ -0,0 +1,123 @@
+#include "../include/PrimeGenerator.h"
+#include "../include/MillerRabin.h"
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+// Odd offsets per sieve window: candidates are start, start+2, ..., start+2*(WINDOW-1)
+static const uint32_t WINDOW = 4096;
+
+// Sieve primes below this bound (6542 odd-and-2 primes, all fit in 32 bits)
+static const uint32_t SIEVE_BOUND = 1 << 16;
+
+// Small odd primes, built once (thread-safe function-local static)
+static const std::vector<uint32_t>& smallPrimes() {
+    static const std::vector<uint32_t> table = [] {
+        std::vector<char> composite(SIEVE_BOUND, 0);
+        std::vector<uint32_t> primes;
+        for (uint32_t i = 3; i < SIEVE_BOUND; i += 2) {
+            if (composite[i]) continue;
+            primes.push_back(i);
+            for (uint64_t j = (uint64_t)i * i; j < SIEVE_BOUND; j += 2 * i) composite[j] = 1;
+        }
+        return primes;
+    }();
+    return table;
+}
+
+PrimeGenerator::PrimeGenerator(int bits, int k) : bits(bits), k(k) {}
+
+// One worker: finds 'count' primes from its own random starts
+static void generateWorker(int bits, int k, size_t count, unsigned long seed,
+                           std::vector<mpz_class>& out, unsigned long long& tested) {
+    const std::vector<uint32_t>& primes = smallPrimes();
+
+    // Only sieve with primes smaller than the candidates themselves
+    size_t numPrimes = primes.size();
+    if (bits <= 17) {
+        numPrimes = std::lower_bound(primes.begin(), primes.end(), 1u << (bits - 1)) - primes.begin();
+    }
+
+    MillerRabin tester;
+    tester.seed(seed);
+    gmp_randclass rng(gmp_randinit_default);
+    rng.seed(seed);
+
+    std::vector<uint32_t> residue(numPrimes);
+    std::vector<char> sieve(WINDOW);
+    mpz_class start, candidate;
+
+    while (out.size() < count) {
+        // Random odd start with the top bit set, so every candidate is k bits
+        start = rng.get_z_bits(bits);
+        mpz_setbit(start.get_mpz_t(), bits - 1);
+        mpz_setbit(start.get_mpz_t(), 0);
+
+        for (size_t i = 0; i < numPrimes; i++) {
+            residue[i] = mpz_fdiv_ui(start.get_mpz_t(), primes[i]);
+        }
+
+        bool found = false;
+        bool overflow = false;
+        while (!found && !overflow) {
+            // Mark every offset j where start + 2j is divisible by a small prime:
+            // start + 2j = 0 (mod p)  <=>  j = (p - r) * 2^-1 (mod p), 2^-1 = (p+1)/2
+            std::fill(sieve.begin(), sieve.end(), 0);
+            for (size_t i = 0; i < numPrimes; i++) {
+                uint64_t p = primes[i];
+                uint64_t j = ((p - residue[i]) % p) * ((p + 1) / 2) % p;
+                for (; j < WINDOW; j += p) sieve[j] = 1;
+            }
+
+            for (uint32_t j = 0; j < WINDOW; j++) {
+                if (sieve[j]) continue;
+                candidate = start + 2 * j;
+
+                // Ran off the top of the k-bit range: restart from a new random point
+                if (mpz_sizeinbase(candidate.get_mpz_t(), 2) != (size_t)bits) {
+                    overflow = true;
+                    break;
+                }
+
+                tested++;
+                if (tester.test(candidate, k)) {
+                    out.push_back(candidate);
+                    found = true;
+                    break;
+                }
+            }
+            if (found || overflow) break;
+
+            // No prime here: slide to the next window and shift the residues by 2*WINDOW
+            start += 2 * WINDOW;
+            for (size_t i = 0; i < numPrimes; i++) {
+                residue[i] = (uint32_t)((residue[i] + 2ULL * WINDOW) % primes[i]);
+            }
+        }
+    }
+}
+
+std::vector<mpz_class> PrimeGenerator::generate(size_t count, int threads, unsigned long seed) {
+    if (threads < 1) threads = 1;
+    smallPrimes(); // build the table before the workers race for it
+
+    std::vector<std::vector<mpz_class>> results(threads);
+    std::vector<unsigned long long> testedPerThread(threads, 0);
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < threads; t++) {
+        size_t share = count / threads + ((size_t)t < count % threads ? 1 : 0);
+        workers.emplace_back(generateWorker, bits, k, share, seed + t,
+                             std::ref(results[t]), std::ref(testedPerThread[t]));
+    }
+    for (auto& w : workers) w.join();
+
+    std::vector<mpz_class> all;
+    all.reserve(count);
+    tested = 0;
+    for (int t = 0; t < threads; t++) {
+        all.insert(all.end(), results[t].begin(), results[t].end());
+        tested += testedPerThread[t];
+    }
+    return all;
+}
@@ -0,0 +1,19 @@
+#include "../include/ProvingTester.h"
+
+ProvingTester::ProvingTester(std::unique_ptr<PrimalityTester> fallback)
+    : fallback(std::move(fallback)) {}
+
+bool ProvingTester::test(const mpz_class& n, int k) {
+    certificate.clear();
+    ProofResult result = prover.prove(n, wantCertificates ? &certificate : nullptr);
+
+    if (result == ProofResult::Unknown) {
+        proof = NumberForm::None;
+        counts[(int)proof]++;
+        return fallback->test(n, k);
+    }
+
+    proof = prover.lastForm();
+    counts[(int)proof]++;
+    return result == ProofResult::Prime;
+}
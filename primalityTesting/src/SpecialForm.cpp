@@ -0,0 +1,255 @@
+#include "../include/SpecialForm.h"
+
+// Primes below TRIAL_BOUND, built once (thread-safe function-local static)
+static const std::vector<unsigned long>& trialPrimes() {
+    static const std::vector<unsigned long> table = [] {
+        const unsigned long bound = SpecialFormProver::TRIAL_BOUND;
+        std::vector<char> composite(bound, 0);
+        std::vector<unsigned long> primes;
+        for (unsigned long i = 2; i < bound; i++) {
+            if (composite[i]) continue;
+            primes.push_back(i);
+            for (unsigned long j = i * i; j < bound; j += i) composite[j] = 1;
+        }
+        return primes;
+    }();
+    return table;
+}
+
+// Odd trial primes grouped so each group's product fits in one word:
+// one mpz_tdiv_ui per group, then plain word remainders per prime
+struct PrimeGroup {
+    unsigned long product;
+    size_t begin, end; // range in trialPrimes()
+};
+
+static const std::vector<PrimeGroup>& trialGroups() {
+    static const std::vector<PrimeGroup> table = [] {
+        const std::vector<unsigned long>& primes = trialPrimes();
+        std::vector<PrimeGroup> groups;
+        for (size_t i = 1; i < primes.size();) { // skip 2
+            PrimeGroup grp = {1, i, i};
+            while (grp.end < primes.size() && grp.product <= ~0UL / primes[grp.end]) {
+                grp.product *= primes[grp.end++];
+            }
+            groups.push_back(grp);
+            i = grp.end;
+        }
+        return groups;
+    }();
+    return table;
+}
+
+// Bases tried per prime factor before Pocklington gives up on n
+static const int POCKLINGTON_BASES = 32;
+
+const char* formName(NumberForm form) {
+    switch (form) {
+        case NumberForm::Mersenne:    return "lucas-lehmer";
+        case NumberForm::Proth:       return "proth";
+        case NumberForm::Pocklington: return "pocklington";
+        default:                      return "none";
+    }
+}
+
+FormInfo detectForm(const mpz_class& n) {
+    FormInfo info;
+    if (n <= 3 || mpz_even_p(n.get_mpz_t())) return info;
+
+    // Mersenne: n+1 is a single bit
+    mpz_class n1 = n + 1;
+    unsigned long p = mpz_scan1(n1.get_mpz_t(), 0);
+    if (mpz_sizeinbase(n1.get_mpz_t(), 2) == p + 1) {
+        info.form = NumberForm::Mersenne;
+        info.exponent = p;
+        return info;
+    }
+
+    // The other two need every base and trial prime below n
+    if (n <= SpecialFormProver::TRIAL_BOUND) return info;
+
+    // Proth: n-1 = k*2^m with k odd and k < 2^m
+    mpz_class nm1 = n - 1;
+    unsigned long m = mpz_scan1(nm1.get_mpz_t(), 0);
+    mpz_class k;
+    mpz_tdiv_q_2exp(k.get_mpz_t(), nm1.get_mpz_t(), m);
+    if (mpz_sizeinbase(k.get_mpz_t(), 2) <= m) {
+        info.form = NumberForm::Proth;
+        info.exponent = m;
+        info.multiplier = k;
+        return info;
+    }
+
+    // Pocklington: peel the small primes off n-1 and see whether the
+    // factored part F reaches past sqrt(n)
+    mpz_ui_pow_ui(info.F.get_mpz_t(), 2, m);
+    info.R = k;
+    info.primes.push_back(2);
+    info.powers.push_back(m);
+    const std::vector<unsigned long>& primes = trialPrimes();
+    for (const PrimeGroup& grp : trialGroups()) {
+        if (info.R == 1) break;
+        unsigned long rem = mpz_tdiv_ui(info.R.get_mpz_t(), grp.product);
+        for (size_t i = grp.begin; i < grp.end; i++) {
+            unsigned long q = primes[i];
+            if (rem % q != 0) continue;
+            unsigned long e = 0;
+            do {
+                mpz_divexact_ui(info.R.get_mpz_t(), info.R.get_mpz_t(), q);
+                e++;
+            } while (mpz_divisible_ui_p(info.R.get_mpz_t(), q));
+            mpz_class qe;
+            mpz_ui_pow_ui(qe.get_mpz_t(), q, e);
+            info.F *= qe;
+            info.primes.push_back(q);
+            info.powers.push_back(e);
+        }
+    }
+
+    // A cofactor with no prime below TRIAL_BOUND that is under its square is prime
+    const unsigned long bound = SpecialFormProver::TRIAL_BOUND;
+    if (info.R > 1 && info.R < (mpz_class)bound * bound) {
+        info.F *= info.R;
+        info.primes.push_back(info.R.get_ui());
+        info.powers.push_back(1);
+        info.R = 1;
+    }
+
+    if (info.F * info.F > n) info.form = NumberForm::Pocklington;
+    return info;
+}
+
+SpecialFormProver::SpecialFormProver() {
+    mpz_init(s);
+    mpz_init(sq);
+    mpz_init(hi);
+    mpz_init(e);
+    mpz_init(y);
+    mpz_init(g);
+}
+
+SpecialFormProver::~SpecialFormProver() {
+    mpz_clear(s);
+    mpz_clear(sq);
+    mpz_clear(hi);
+    mpz_clear(e);
+    mpz_clear(y);
+    mpz_clear(g);
+}
+
+ProofResult SpecialFormProver::prove(const mpz_class& n, std::string* certificate) {
+    FormInfo info = detectForm(n);
+    form = info.form;
+    switch (info.form) {
+        case NumberForm::Mersenne:    return lucasLehmer(n, info, certificate);
+        case NumberForm::Proth:       return proth(n, info, certificate);
+        case NumberForm::Pocklington: return pocklington(n, info, certificate);
+        default:                      return ProofResult::Unknown;
+    }
+}
+
+ProofResult SpecialFormProver::lucasLehmer(const mpz_class& n, const FormInfo& info, std::string* certificate) {
+    const unsigned long p = info.exponent;
+    const mpz_srcptr N = n.get_mpz_t();
+
+    // 2^p - 1 is composite whenever p is (2^a - 1 divides it)
+    for (unsigned long d = 2; d * d <= p; d++) {
+        if (p % d == 0) return ProofResult::Composite;
+    }
+
+    // s_0 = 4, s_(i+1) = s_i^2 - 2 mod n; n is prime iff s_(p-2) = 0
+    mpz_set_ui(s, 4);
+    for (unsigned long i = 0; i + 2 < p; i++) {
+        mpz_mul(sq, s, s);
+
+        // x mod 2^p - 1 = (x mod 2^p) + (x >> p): no division, and since
+        // sq < 2^(2p) one fold leaves it below 2n
+        mpz_tdiv_q_2exp(hi, sq, p);
+        mpz_tdiv_r_2exp(sq, sq, p);
+        mpz_add(sq, sq, hi);
+        if (mpz_cmp(sq, N) >= 0) mpz_sub(sq, sq, N);
+
+        if (mpz_cmp_ui(sq, 2) < 0) mpz_add(sq, sq, N);
+        mpz_sub_ui(s, sq, 2);
+    }
+
+    if (mpz_sgn(s) != 0) return ProofResult::Composite;
+    if (certificate) {
+        *certificate = "PRIME " + n.get_str() + "\nMETHOD lucas-lehmer\nP "
+                     + std::to_string(p) + "\nEND\n";
+    }
+    return ProofResult::Prime;
+}
+
+ProofResult SpecialFormProver::proth(const mpz_class& n, const FormInfo& info, std::string* certificate) {
+    const mpz_srcptr N = n.get_mpz_t();
+
+    // A base with Jacobi symbol (a/n) = -1 settles it either way: if n is
+    // prime, Euler's criterion forces a^((n-1)/2) = -1, and if that holds,
+    // Proth's theorem makes n prime. Only squares never yield such a base.
+    for (unsigned long a : trialPrimes()) {
+        if (a == 2) continue;
+        int j = mpz_ui_kronecker(a, N);
+        if (j == 0) return ProofResult::Composite; // a < n divides n
+        if (j == 1) continue;
+
+        mpz_sub_ui(e, N, 1);
+        mpz_tdiv_q_2exp(e, e, 1);
+        mpz_set_ui(y, a);
+        mpz_powm(y, y, e, N);
+
+        mpz_add_ui(y, y, 1);
+        if (mpz_cmp(y, N) != 0) return ProofResult::Composite;
+        if (certificate) {
+            *certificate = "PRIME " + n.get_str() + "\nMETHOD proth\nK "
+                         + info.multiplier.get_str() + " M " + std::to_string(info.exponent)
+                         + " A " + std::to_string(a) + "\nEND\n";
+        }
+        return ProofResult::Prime;
+    }
+    return ProofResult::Unknown;
+}
+
+ProofResult SpecialFormProver::pocklington(const mpz_class& n, const FormInfo& info, std::string* certificate) {
+    const mpz_srcptr N = n.get_mpz_t();
+    const std::vector<unsigned long>& bases = trialPrimes();
+    std::vector<unsigned long> witnesses;
+
+    // Each prime q | F needs a base a with a^(n-1) = 1 and
+    // gcd(a^((n-1)/q) - 1, n) = 1
+    for (unsigned long q : info.primes) {
+        mpz_sub_ui(e, N, 1);
+        mpz_divexact_ui(e, e, q);
+
+        bool found = false;
+        for (int b = 0; b < POCKLINGTON_BASES && !found; b++) {
+            unsigned long a = bases[b];
+            mpz_set_ui(y, a);
+            mpz_powm(y, y, e, N);           // a^((n-1)/q)
+            mpz_powm_ui(s, y, q, N);        // a^(n-1), from the same power
+            if (mpz_cmp_ui(s, 1) != 0) return ProofResult::Composite; // Fermat witness
+
+            mpz_sub_ui(y, y, 1);
+            mpz_gcd(g, y, N);
+            if (mpz_cmp_ui(g, 1) == 0) {
+                witnesses.push_back(a);
+                found = true;
+            } else if (mpz_cmp(g, N) != 0) {
+                return ProofResult::Composite; // proper factor of n
+            }
+            // g = n: a^((n-1)/q) = 1, this base says nothing about q
+        }
+        if (!found) return ProofResult::Unknown;
+    }
+
+    if (certificate) {
+        std::string c = "PRIME " + n.get_str() + "\nMETHOD pocklington\nF "
+                      + info.F.get_str() + " R " + info.R.get_str() + "\n";
+        for (size_t i = 0; i < info.primes.size(); i++) {
+            c += "FACTOR " + std::to_string(info.primes[i]) + " " + std::to_string(info.powers[i])
+               + " " + std::to_string(witnesses[i]) + "\n";
+        }
+        *certificate = c + "END\n";
+    }
+    return ProofResult::Prime;
+}
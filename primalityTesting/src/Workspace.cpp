@@ -0,0 +1,40 @@
+#include "../include/Workspace.h"
+
+Workspace::Workspace() : capacityBits(0) {
+    mpz_init(a);
+    mpz_init(x);
+    mpz_init(sq);
+    mpz_init(d);
+    mpz_init(nMinus1);
+    mpz_init(nMinus4);
+    gmp_randinit_default(rng);
+}
+
+Workspace::~Workspace() {
+    mpz_clear(a);
+    mpz_clear(x);
+    mpz_clear(sq);
+    mpz_clear(d);
+    mpz_clear(nMinus1);
+    mpz_clear(nMinus4);
+    gmp_randclear(rng);
+}
+
+void Workspace::prepare(const mpz_class& n) {
+    size_t bits = mpz_sizeinbase(n.get_mpz_t(), 2);
+
+    // Only ever grow: a batch of same-sized numbers allocates exactly once.
+    // One spare limb covers the carry out of the +2 on the witness.
+    if (bits > capacityBits) {
+        capacityBits = bits + GMP_NUMB_BITS;
+        mpz_realloc2(a, capacityBits);
+        mpz_realloc2(x, capacityBits);
+        mpz_realloc2(sq, 2 * capacityBits);
+        mpz_realloc2(d, capacityBits);
+        mpz_realloc2(nMinus1, capacityBits);
+        mpz_realloc2(nMinus4, capacityBits);
+    }
+
+    mpz_sub_ui(nMinus1, n.get_mpz_t(), 1);
+    mpz_sub_ui(nMinus4, n.get_mpz_t(), 4);
+}
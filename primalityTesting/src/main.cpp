@@ -5,41 +5,175 @@
 #include <memory>
 #include <chrono> // For high-precision stopwatch
 #include <cstring> // For strcmp
+#include <cstdlib> // For malloc/free
+#include <climits> // For CHAR_BIT
+#include <random>
+#include <map>
 #include "../include/MillerRabin.h"
+#include "../include/BatchMillerRabin.h"
 #include "../include/Fermat.h"
+#include "../include/ProvingTester.h"
+#include "../include/CandidateFile.h"
+#include "../include/PrimeGenerator.h"
+#include "../../common/result_sink.h"
 
 // A simple helper to print usage instructions if the user messes up
 void printUsage() {
-    std::cerr << "Usage: ./primality_test --algo <miller|fermat> --file <path_to_file> --k <iterations>" << std::endl;
+    std::cerr << "Usage: ./primality_test --algo <miller|miller-batch|fermat> --file <path_to_file> --k <iterations>"
+              << " [--seed <n>] [--witnesses <random|fixed>] [--alloc-stats] [--scalar-kernel]"
+              << " [--out <results.csv|results.col>] [--profile] [--prove] [--certs <certs.txt>]" << std::endl;
+    std::cerr << "       ./primality_test --file <numbers.txt> --to-bin <numbers.bin>" << std::endl;
+    std::cerr << "       ./primality_test --generate <count> --bits <b> [--threads <t>] [--k <iterations>]"
+              << " [--seed <n>] [--to-bin <primes.bin>]" << std::endl;
+    std::cerr << "--file accepts decimal text (one number per line) or the binary .bin format" << std::endl;
+    std::cerr << "--profile adds per-phase nanosecond columns and round/squaring counts (not with miller-batch)" << std::endl;
+    std::cerr << "--prove proves Mersenne, Proth and Pocklington-form numbers before --algo (not with miller-batch);"
+              << " --certs writes their prime certificates" << std::endl;
+}
+
+// GMP allocation counters (enabled with --alloc-stats)
+// GMP routes every limb allocation through these hooks, so we can see
+// exactly how much heap traffic the testers generate per number.
+static unsigned long long gmpAllocs = 0;
+static unsigned long long gmpReallocs = 0;
+static unsigned long long gmpFrees = 0;
+
+static void* countingAlloc(size_t size) {
+    gmpAllocs++;
+    return std::malloc(size);
+}
+
+static void* countingRealloc(void* ptr, size_t /*oldSize*/, size_t newSize) {
+    gmpReallocs++;
+    return std::realloc(ptr, newSize);
+}
+
+static void countingFree(void* ptr, size_t /*size*/) {
+    gmpFrees++;
+    std::free(ptr);
 }
 
 int main(int argc, char* argv[]) {
     // 1. ARGUMENT PARSING
-    // We expect 7 arguments total (program name + 3 flags + 3 values)
-    if (argc < 7) {
-        printUsage();
-        return 1;
-    }
-
     std::string algoType;
     std::string filePath;
     int k = 5;
+    bool allocStats = false;
+    bool haveSeed = false;
+    unsigned long seed = 0;
+    std::string witnessType = "random";
+    std::string binOut;
+    std::string outPath = "-"; // CSV on stdout
+    size_t generateCount = 0;
+    int bits = 0;
+    int threads = 1;
+    bool scalarKernel = false;
+    bool profiling = false;
+    bool proving = false;
+    std::string certsPath;
 
     // Loop through arguments to find our flags
     for (int i = 1; i < argc; i++) {
-        if (std::strcmp(argv[i], "--algo") == 0) {
+        if (std::strcmp(argv[i], "--alloc-stats") == 0) {
+            allocStats = true;
+        } else if (std::strcmp(argv[i], "--scalar-kernel") == 0) {
+            scalarKernel = true;
+        } else if (std::strcmp(argv[i], "--profile") == 0) {
+            profiling = true;
+        } else if (std::strcmp(argv[i], "--prove") == 0) {
+            proving = true;
+        } else if (std::strcmp(argv[i], "--certs") == 0) {
+            certsPath = argv[i + 1];
+            proving = true;
+        } else if (std::strcmp(argv[i], "--algo") == 0) {
             algoType = argv[i + 1];
         } else if (std::strcmp(argv[i], "--file") == 0) {
             filePath = argv[i + 1];
         } else if (std::strcmp(argv[i], "--k") == 0) {
             k = std::stoi(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--seed") == 0) {
+            seed = std::stoul(argv[i + 1]);
+            haveSeed = true;
+        } else if (std::strcmp(argv[i], "--witnesses") == 0) {
+            witnessType = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--out") == 0) {
+            outPath = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--to-bin") == 0) {
+            binOut = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--generate") == 0) {
+            generateCount = std::stoul(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--bits") == 0) {
+            bits = std::stoi(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--threads") == 0) {
+            threads = std::stoi(argv[i + 1]);
         }
     }
 
+    if (!haveSeed) {
+        std::random_device rd;
+        seed = ((unsigned long)rd() << 32) ^ rd();
+    }
+
+    // Generation mode: sieve-then-test random primes, one decimal per line
+    // (same layout as data/*.txt) or a binary candidate file with --to-bin
+    if (generateCount > 0) {
+        if (bits < 3) {
+            std::cerr << "Error: --generate needs --bits >= 3" << std::endl;
+            return 1;
+        }
+        std::cerr << "seed=" << seed << std::endl;
+
+        PrimeGenerator generator(bits, k);
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<mpz_class> primes = generator.generate(generateCount, threads, seed);
+        auto end = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+
+        if (!binOut.empty()) {
+            CandidateWriter writer;
+            bool ok = writer.open(binOut);
+            for (size_t i = 0; ok && i < primes.size(); i++) ok = writer.write(primes[i]);
+            if (!writer.close() || !ok) {
+                std::cerr << "Error: write failed on " << binOut << std::endl;
+                return 1;
+            }
+        } else {
+            for (const mpz_class& p : primes) std::cout << p << "\n";
+            std::cout.flush();
+        }
+
+        std::cerr << "generated " << primes.size() << " primes of " << bits << " bits"
+                  << " with " << threads << " threads in " << seconds << " s"
+                  << " (" << primes.size() / seconds << " primes/s, "
+                  << generator.testedCandidates() << " Miller-Rabin calls)" << std::endl;
+        return 0;
+    }
+
+    if (filePath.empty() || (algoType.empty() && binOut.empty())) {
+        printUsage();
+        return 1;
+    }
+
+    // Conversion mode: text -> binary candidate file, no testing
+    if (!binOut.empty()) {
+        if (!convertTextToBinary(filePath, binOut)) return 1;
+        std::cerr << "Wrote " << binOut << std::endl;
+        return 0;
+    }
+
+    if (allocStats) {
+        mp_set_memory_functions(countingAlloc, countingRealloc, countingFree);
+    }
+
     // 2. SETUP THE ALGORITHM
     std::unique_ptr<PrimalityTester> tester;
+    BatchMillerRabin* batchTester = nullptr;
     if (algoType == "miller") {
         tester = std::make_unique<MillerRabin>();
+    } else if (algoType == "miller-batch") {
+        batchTester = new BatchMillerRabin();
+        batchTester->setScalarKernel(scalarKernel);
+        tester.reset(batchTester);
     } else if (algoType == "fermat") {
         tester = std::make_unique<Fermat>();
     } else {
@@ -47,22 +181,89 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    // --profile: the tester charges its phases to 'prof', which is cleared
+    // before each number and folded into 'profTotal' after its row.
+    // The lane kernels have no per-number phases, so batch mode skips it.
+    PhaseProfile prof, profTotal;
+    if (profiling && batchTester) {
+        std::cerr << "--profile is not supported with miller-batch, ignoring it" << std::endl;
+        profiling = false;
+    }
+    if (profiling) tester->setProfile(&prof);
+
+    // Seed ONCE for the whole run. Without --seed we drew one above and
+    // report it on stderr, so any run can be replayed exactly with --seed.
+    tester->seed(seed);
+    profTotal.merge(prof);
+    std::cerr << "seed=" << seed << std::endl;
+
+    if (witnessType == "fixed") {
+        tester->setWitnessMode(WitnessMode::Fixed);
+    } else if (witnessType != "random") {
+        std::cerr << "Unknown witness schedule: " << witnessType << std::endl;
+        return 1;
+    }
+
+    // --prove: special forms get a proof, the configured tester the rest
+    ProvingTester* prover = nullptr;
+    std::ofstream certs;
+    if (proving && batchTester) {
+        std::cerr << "--prove is not supported with miller-batch, ignoring it" << std::endl;
+        proving = false;
+    }
+    if (proving) {
+        prover = new ProvingTester(std::move(tester));
+        tester.reset(prover);
+        if (!certsPath.empty()) {
+            certs.open(certsPath);
+            if (!certs.is_open()) {
+                std::cerr << "Error: Could not open " << certsPath << std::endl;
+                return 1;
+            }
+            prover->setCertificates(true);
+        }
+    }
+
     // 3. OPEN THE FILE
-    std::ifstream infile(filePath);
-    if (!infile.is_open()) {
+    // Binary files are mmap'd and imported limb-wise; text is parsed line by line.
+    CandidateReader binReader;
+    std::ifstream infile;
+    bool binaryInput = CandidateReader::isBinary(filePath);
+    if (binaryInput ? !binReader.open(filePath) : (infile.open(filePath), !infile.is_open())) {
         std::cerr << "Error: Could not open file " << filePath << std::endl;
         return 1;
     }
 
-    std::string line;
+    size_t numbersTested = 0;
+    unsigned long long testAllocs = 0;
+    unsigned long long testReallocs = 0;
+    long long testTimeUS = 0;
+
+    // --profile: how many rounds / squarings each composite took to reject
+    std::map<uint64_t, size_t> roundsHist, squaringsHist;
+
     // 4. PROCESS EACH NUMBER
     // Format of output: Number(truncated), Result(0/1), Time(microseconds)
-    std::cout << "Number,Result,TimeUS" << std::endl;
-
-    while (std::getline(infile, line)) {
-        if (line.empty()) continue;
+    // Rows are queued and written by a background thread, so no flush lands
+    // between two timed tests; --out picks a file (.col: typed columns)
+    // --profile appends TimeNS, one <Phase>NS column per per-number phase,
+    // and the Rounds / Squarings the test ran; --prove appends Proof, the
+    // form that settled the number ("none": the probabilistic tester did)
+    std::vector<std::string> columns = {"Number", "Result", "TimeUS"};
+    if (proving) columns.push_back("Proof");
+    if (profiling) {
+        columns.push_back("TimeNS");
+        for (int p = 0; p < PhaseProfile::NUM_PHASES; p++) {
+            if (p != PhaseProfile::Seed) columns.push_back(std::string(PhaseProfile::phaseName(p)) + "NS");
+        }
+        columns.push_back("Rounds");
+        columns.push_back("Squarings");
+    }
+    ResultSink results(outPath, columns);
 
-        mpz_class n(line); // Convert string to Big Int
+    auto processNumber = [&](const mpz_class& n) {
+        unsigned long long allocsBefore = gmpAllocs;
+        unsigned long long reallocsBefore = gmpReallocs;
 
         // --- START STOPWATCH ---
         auto start = std::chrono::high_resolution_clock::now();
@@ -75,14 +276,171 @@ int main(int argc, char* argv[]) {
         // Calculate duration in microseconds
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
 
+        numbersTested++;
+        testAllocs += gmpAllocs - allocsBefore;
+        testReallocs += gmpReallocs - reallocsBefore;
+        testTimeUS += duration;
+
         // Output CSV row
         // We only print the first 20 digits of n to keep logs clean
+        uint64_t formatStart = profiling ? PhaseProfile::now() : 0;
         std::string n_str = n.get_str();
         std::string n_trunc = (n_str.length() > 20) ? n_str.substr(0, 20) + "..." : n_str;
 
-        std::cout << n_trunc << "," << isPrime << "," << duration << std::endl;
+        if (prover && certs.is_open() && !prover->lastCertificate().empty()) {
+            certs << prover->lastCertificate();
+        }
+
+        if (!profiling) {
+            auto row = results.row();
+            row << n_trunc << isPrime << duration;
+            if (prover) row << formName(prover->lastProof());
+            return;
+        }
+
+        prof.charge(PhaseProfile::Output, formatStart);
+        auto row = results.row();
+        row << n_trunc << isPrime << duration;
+        if (prover) row << formName(prover->lastProof());
+        row << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        for (int p = 0; p < PhaseProfile::NUM_PHASES; p++) {
+            if (p != PhaseProfile::Seed) row << prof.ns[p];
+        }
+        row << prof.rounds << prof.squarings;
+
+        profTotal.merge(prof);
+        if (!isPrime) {
+            roundsHist[prof.rounds]++;
+            squaringsHist[prof.squarings]++;
+        }
+    };
+
+    // Pulls the next candidate from whichever input format we opened
+    std::string line;
+    auto nextCandidate = [&](mpz_class& n) {
+        if (binaryInput) return binReader.next(n.get_mpz_t());
+        while (std::getline(infile, line)) {
+            if (line.empty()) continue;
+            // Convert string to Big Int; a bad line is reported and skipped
+            if (n.set_str(line, 10) != 0) {
+                std::cerr << "Warning: skipping, not a decimal number: " << line << std::endl;
+                continue;
+            }
+            return true;
+        }
+        return false;
+    };
+
+    // Same, with the parse (or binary import) charged to prof.Parse
+    auto nextProfiled = [&](mpz_class& n) {
+        prof.clear();
+        uint64_t t = PhaseProfile::now();
+        bool got = nextCandidate(n);
+        prof.charge(PhaseProfile::Parse, t);
+        return got;
+    };
+
+    mpz_class n;
+    if (binaryInput) {
+        // One buffer sized for the largest record, refilled in place
+        // (open() checked maxLimbs against the file size)
+        mp_bitcnt_t bits = binReader.maxLimbs() * sizeof(uint64_t) * CHAR_BIT;
+        mpz_realloc2(n.get_mpz_t(), (bits + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS * GMP_NUMB_BITS);
     }
 
-    infile.close();
+    if (batchTester) {
+        // Batch mode: test blocks of candidates lane-parallel, then run the
+        // plain GMP Miller-Rabin over the same block for the throughput comparison
+        const size_t BLOCK = 4096;
+        MillerRabin gmpTester;
+        gmpTester.seed(seed);
+        if (witnessType == "fixed") gmpTester.setWitnessMode(WitnessMode::Fixed);
+
+        std::vector<mpz_class> block;
+        double batchSeconds = 0, gmpSeconds = 0;
+        size_t mismatches = 0;
+        bool more = true;
+        while (more) {
+            block.clear();
+            while (block.size() < BLOCK && (more = nextCandidate(n))) block.push_back(n);
+            if (block.empty()) break;
+
+            auto start = std::chrono::high_resolution_clock::now();
+            std::vector<char> verdicts = batchTester->testBatch(block, k);
+            auto mid = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < block.size(); i++) {
+                if (gmpTester.test(block[i], k) != (verdicts[i] != 0)) mismatches++;
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+
+            double blockSeconds = std::chrono::duration<double>(mid - start).count();
+            batchSeconds += blockSeconds;
+            gmpSeconds += std::chrono::duration<double>(end - mid).count();
+
+            // Per-number time is the block time amortized over the block
+            double perNumberUS = blockSeconds * 1e6 / block.size();
+            for (size_t i = 0; i < block.size(); i++) {
+                std::string n_str = block[i].get_str();
+                std::string n_trunc = (n_str.length() > 20) ? n_str.substr(0, 20) + "..." : n_str;
+                results.row() << n_trunc << (int)verdicts[i] << perNumberUS;
+            }
+            numbersTested += block.size();
+        }
+
+        if (numbersTested > 0) {
+            std::cerr << "batch: kernel=" << (batchTester->usingSimd() ? "avx512-ifma" : "scalar")
+                      << " numbers=" << numbersTested
+                      << " batch=" << numbersTested / batchSeconds << " cand/s"
+                      << " gmp=" << numbersTested / gmpSeconds << " cand/s"
+                      << " speedup=" << gmpSeconds / batchSeconds << "x"
+                      << " mismatches=" << mismatches << std::endl;
+        }
+        return 0;
+    }
+
+    while (profiling ? nextProfiled(n) : nextCandidate(n)) {
+        processNumber(n);
+    }
+    if (!binaryInput) infile.close();
+
+    if (prover && numbersTested > 0) {
+        std::cerr << "prove: numbers=" << numbersTested;
+        for (NumberForm form : {NumberForm::Mersenne, NumberForm::Proth, NumberForm::Pocklington}) {
+            std::cerr << " " << formName(form) << "=" << prover->settled(form);
+        }
+        std::cerr << " fallback=" << prover->settled(NumberForm::None) << std::endl;
+    }
+
+    if (profiling && numbersTested > 0) {
+        std::cerr << "profile: " << tester->name() << " numbers=" << numbersTested
+                  << " SeedNS=" << profTotal.ns[PhaseProfile::Seed];
+        for (int p = 0; p < PhaseProfile::NUM_PHASES; p++) {
+            if (p == PhaseProfile::Seed) continue;
+            std::cerr << " " << PhaseProfile::phaseName(p) << "NS/number="
+                      << (double)profTotal.ns[p] / numbersTested;
+        }
+        std::cerr << std::endl;
+
+        // "<count>:<composites>" pairs, fewest rounds / squarings first
+        auto printHist = [](const char* label, const std::map<uint64_t, size_t>& hist) {
+            std::cerr << "profile: composites by " << label << ":";
+            for (const auto& [value, count] : hist) std::cerr << " " << value << ":" << count;
+            std::cerr << std::endl;
+        };
+        printHist("rounds", roundsHist);
+        printHist("squarings", squaringsHist);
+    }
+
+    // Summary goes to stderr so the CSV on stdout stays clean
+    if (allocStats && numbersTested > 0) {
+        std::cerr << "alloc-stats: " << tester->name()
+                  << " numbers=" << numbersTested
+                  << " allocs=" << testAllocs
+                  << " reallocs=" << testReallocs
+                  << " allocs/number=" << (double)testAllocs / numbersTested
+                  << " timeUS=" << testTimeUS
+                  << " timeUS/number=" << (double)testTimeUS / numbersTested
+                  << std::endl;
+    }
     return 0;
 }
\ No newline at end of file
@@ -2,6 +2,11 @@ import pandas as pd
 import matplotlib.pyplot as plt
 import seaborn as sns
 import os
+import sys
+
+# CSV or the typed .col files written by common/result_sink.h
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "common"))
+from result_sink import read_results
 
 # Configuration
 INPUT_FILE = "results.csv"
@@ -12,7 +17,7 @@ def main():
     # 1. Load Data
     print(f"Loading data from {INPUT_FILE}...")
     try:
-        df = pd.read_csv(INPUT_FILE)
+        df = read_results(INPUT_FILE)
     except FileNotFoundError:
         print("Error: results.csv not found. Please run the C++ benchmark first.")
         return
@@ -4,6 +4,10 @@
 #include <chrono>
 #include <cstdlib>
 #include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "../common/result_sink.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -13,6 +17,8 @@ using namespace std::chrono;
 // ==========================================
 const int NUM_RUNS = 10; 
 const vector<int> SIZES = {100, 200, 500, 1000, 2000, 5000, 10000, 20000}; 
+const int TOP_K_PERCENT = 1;   // partial sort keeps the smallest 1% (at least one)
+const int NUM_QUANTILES = 9;   // multi-select finds the deciles
 
 // ==========================================
 // 1. STANDARD QUICKSORT (Lomuto)
@@ -58,48 +64,59 @@ void quickSortRandomized(vector<int>& arr, int low, int high) {
 // ==========================================
 // 3. DUAL-PIVOT QUICKSORT
 // ==========================================
-void quickSortDualPivot(vector<int>& arr, int low, int high) {
-    if (low < high) {
-        // Swap low and high to ensure arr[low] <= arr[high]
-        if (arr[low] > arr[high]) {
-            swap(arr[low], arr[high]);
-        }
+// Partitions arr[low..high] (low < high) around p1 = arr[low] <= p2 = arr[high]:
+// on return arr[lp] = p1, arr[rp] = p2, and the three parts in between
+// hold < p1, [p1, p2] and > p2.
+void partitionDualPivot(vector<int>& arr, int low, int high, int& lp, int& rp) {
+    // Swap low and high to ensure arr[low] <= arr[high]
+    if (arr[low] > arr[high]) {
+        swap(arr[low], arr[high]);
+    }
 
-        // Pivots
-        int p1 = arr[low];
-        int p2 = arr[high];
+    // Pivots
+    int p1 = arr[low];
+    int p2 = arr[high];
 
-        int l = low + 1; // Left pointer
-        int g = high - 1; // Right pointer
-        int k = low + 1; // Iterator
+    int l = low + 1; // Left pointer
+    int g = high - 1; // Right pointer
+    int k = low + 1; // Iterator
 
-        while (k <= g) {
-            // If element is smaller than left pivot
+    while (k <= g) {
+        // If element is smaller than left pivot
+        if (arr[k] < p1) {
+            swap(arr[k], arr[l]);
+            l++;
+        }
+        // If element is greater than right pivot
+        else if (arr[k] > p2) {
+            while (arr[g] > p2 && k < g) {
+                g--;
+            }
+            swap(arr[k], arr[g]);
+            g--;
+            // After swapping, the new arr[k] might be < p1
             if (arr[k] < p1) {
                 swap(arr[k], arr[l]);
                 l++;
             }
-            // If element is greater than right pivot
-            else if (arr[k] > p2) {
-                while (arr[g] > p2 && k < g) {
-                    g--;
-                }
-                swap(arr[k], arr[g]);
-                g--;
-                // After swapping, the new arr[k] might be < p1
-                if (arr[k] < p1) {
-                    swap(arr[k], arr[l]);
-                    l++;
-                }
-            }
-            k++;
         }
-        l--; 
-        g++;
+        k++;
+    }
+    l--; 
+    g++;
 
-        // Bring pivots to their correct positions
-        swap(arr[low], arr[l]);
-        swap(arr[high], arr[g]);
+    // Bring pivots to their correct positions
+    swap(arr[low], arr[l]);
+    swap(arr[high], arr[g]);
+
+    lp = l;
+    rp = g;
+}
+
+void quickSortDualPivot(vector<int>& arr, int low, int high) {
+    if (low < high) {
+        int l, g;
+        partitionDualPivot(arr, low, high, l, g);
 
         // Recursively sort the three parts
         quickSortDualPivot(arr, low, l - 1);
@@ -108,6 +125,319 @@ void quickSortDualPivot(vector<int>& arr, int low, int high) {
     }
 }
 
+// ==========================================
+// 4. SELECTION (introselect, partial sort, multi-select)
+// ==========================================
+// All of these take an absolute index k in [low, high] and leave arr[k]
+// holding the value a full sort would put there, with nothing larger to
+// its left and nothing smaller to its right.
+
+const int SELECT_CUTOFF = 16; // ranges this small are insertion-sorted
+
+void insertionSort(vector<int>& arr, int low, int high) {
+    for (int i = low + 1; i <= high; i++) {
+        int x = arr[i];
+        int j = i - 1;
+        while (j >= low && arr[j] > x) {
+            arr[j + 1] = arr[j];
+            j--;
+        }
+        arr[j + 1] = x;
+    }
+}
+
+// Dutch-flag partition around the value 'pivot'; on return arr[lt..gt]
+// are exactly the copies of it. Unlike Lomuto this stays linear when the
+// range is full of duplicates.
+void partitionThreeWay(vector<int>& arr, int low, int high, int pivot, int& lt, int& gt) {
+    lt = low;
+    gt = high;
+    int i = low;
+    while (i <= gt) {
+        if (arr[i] < pivot) swap(arr[i++], arr[lt++]);
+        else if (arr[i] > pivot) swap(arr[i], arr[gt--]);
+        else i++;
+    }
+}
+
+void introSelect(vector<int>& arr, int low, int high, int k);
+
+// Median of the medians of groups of five: a pivot with at least 3/10 of
+// the range on either side
+int medianOfMedians(vector<int>& arr, int low, int high) {
+    int m = low;
+    for (int i = low; i <= high; i += 5) {
+        int end = min(i + 4, high);
+        insertionSort(arr, i, end);
+        swap(arr[m++], arr[i + (end - i) / 2]);
+    }
+    int mid = low + (m - 1 - low) / 2;
+    introSelect(arr, low, m - 1, mid);
+    return arr[mid];
+}
+
+// Quickselect on partitionRandomized. Every two partitions must at least
+// halve the range; if they do not, the rest of the search uses
+// median-of-medians pivots, so the worst case is O(n) rather than O(n^2).
+void introSelect(vector<int>& arr, int low, int high, int k) {
+    bool fallback = false;
+    int span = high - low;
+    int steps = 0;
+
+    while (high - low >= SELECT_CUTOFF) {
+        if (!fallback) {
+            int pi = partitionRandomized(arr, low, high);
+            if (k == pi) return;
+            if (k < pi) high = pi - 1;
+            else low = pi + 1;
+
+            if (++steps % 2 == 0) {
+                if (high - low > span / 2) fallback = true;
+                span = high - low;
+            }
+        } else {
+            int lt, gt;
+            partitionThreeWay(arr, low, high, medianOfMedians(arr, low, high), lt, gt);
+            if (k < lt) high = lt - 1;
+            else if (k > gt) low = gt + 1;
+            else return;
+        }
+    }
+    insertionSort(arr, low, high);
+}
+
+// Sorts the k smallest values into arr[low..low+k-1] (the rest end up
+// in arbitrary order): select the boundary, then sort only the prefix.
+// The prefix goes to std::sort, not the Lomuto sorts above, which are
+// quadratic when the prefix is full of equal keys.
+void partialSort(vector<int>& arr, int low, int high, int k) {
+    if (k <= 0) return;
+    int last = min(low + k - 1, high);
+    introSelect(arr, low, high, last);
+    sort(arr.begin() + low, arr.begin() + last);
+}
+
+// Selects every index in ks[kb..ke) (sorted, inside [low, high]) in one
+// recursive pass. Each dual-pivot partition settles both pivots and sends
+// every target into one of three parts, so q targets cost O(n log q)
+// expected instead of q separate selections. Pivots are drawn at random,
+// which keeps sorted input away from the dual-pivot worst case.
+void multiSelect(vector<int>& arr, int low, int high, const vector<int>& ks, int kb, int ke) {
+    while (kb < ke) {
+        if (high - low < SELECT_CUTOFF) {
+            insertionSort(arr, low, high);
+            return;
+        }
+        if (ke - kb == 1) {
+            introSelect(arr, low, high, ks[kb]);
+            return;
+        }
+
+        swap(arr[low], arr[low + rand() % (high - low + 1)]);
+        swap(arr[high], arr[low + 1 + rand() % (high - low)]);
+        int l, g;
+        partitionDualPivot(arr, low, high, l, g);
+
+        // Targets up to l, up to g, and past g
+        int a = lower_bound(ks.begin() + kb, ks.begin() + ke, l) - ks.begin();
+        int b = lower_bound(ks.begin() + a, ks.begin() + ke, g) - ks.begin();
+        multiSelect(arr, low, l - 1, ks, kb, a);
+        if (a < ke && ks[a] == l) a++;
+        // Equal pivots mean the middle part is all copies of them
+        if (arr[l] != arr[g]) multiSelect(arr, l + 1, g - 1, ks, a, b);
+        if (b < ke && ks[b] == g) b++;
+        low = g + 1;
+        kb = b;
+    }
+}
+
+void multiSelect(vector<int>& arr, int low, int high, const vector<int>& ks) {
+    multiSelect(arr, low, high, ks, 0, ks.size());
+}
+
+// ==========================================
+// 5. ADAPTIVE DISPATCH
+// ==========================================
+// adaptiveSort samples the input, sorts it into one of three classes and
+// runs the engine and insertion-sort cutoff the profile gives for that
+// class and size. The built-in profile is a reasonable default;
+// "--calibrate" measures this machine and writes a profile file that
+// later runs load at startup.
+
+enum SortEngine { ENGINE_LOMUTO, ENGINE_DUAL_PIVOT, ENGINE_THREE_WAY, NUM_ENGINES };
+enum InputClass { CLASS_RANDOM, CLASS_NEARLY_SORTED, CLASS_FEW_UNIQUE, NUM_CLASSES };
+
+const char* ENGINE_NAMES[NUM_ENGINES] = {"lomuto", "dualpivot", "threeway"};
+const char* CLASS_NAMES[NUM_CLASSES] = {"random", "nearlysorted", "fewunique"};
+
+// Profile rows cover n up to each bound; the last one covers everything
+const int NUM_BUCKETS = 4;
+const int SIZE_BUCKETS[NUM_BUCKETS] = {1000, 10000, 100000, 1000000};
+const int SAMPLE_SIZE = 128;
+
+struct SortPlan {
+    SortEngine engine;
+    int cutoff;
+};
+
+struct SortProfile {
+    double nearlySorted = 0.9; // fraction of ordered sample neighbours
+    double fewUnique = 0.25;   // fraction of distinct sample values
+    SortPlan plan[NUM_CLASSES][NUM_BUCKETS];
+
+    // Defaults from one calibration run on an x86-64 desktop: the
+    // randomized dual-pivot sort wins nearly everywhere, including few
+    // unique values, because equal pivots end the middle part early
+    SortProfile() {
+        for (int b = 0; b < NUM_BUCKETS; b++) {
+            plan[CLASS_RANDOM][b] = {ENGINE_DUAL_PIVOT, 48};
+            plan[CLASS_NEARLY_SORTED][b] = {ENGINE_DUAL_PIVOT, 64};
+            plan[CLASS_FEW_UNIQUE][b] = {ENGINE_DUAL_PIVOT, 64};
+        }
+    }
+};
+
+SortProfile profile;
+
+int sizeBucket(int n) {
+    int b = 0;
+    while (b + 1 < NUM_BUCKETS && n > SIZE_BUCKETS[b]) b++;
+    return b;
+}
+
+// Quicksort down to 'cutoff', then insertion sort. Recurses into the
+// smaller parts and loops on the largest one; every part recursed into
+// holds at most half the range, so the stack is O(log n) in the worst
+// case. Pivots are random for every engine, so sorted input is not a
+// worst case for the running time either.
+//
+// Lomuto sends every copy of the pivot to one side, so a range of equal
+// keys splits 0 / n-1 whatever the pivot. A split that lopsided (less
+// than 1/LOMUTO_SKEW of the range on the smaller side) switches the rest
+// of that range to the three-way engine, which is linear on such runs.
+const int LOMUTO_SKEW = 64;
+
+void hybridSort(vector<int>& arr, int low, int high, SortPlan plan) {
+    while (high - low + 1 > plan.cutoff) {
+        if (plan.engine == ENGINE_LOMUTO) {
+            int pi = partitionRandomized(arr, low, high);
+            if (min(pi - low, high - pi) < (high - low + 1) / LOMUTO_SKEW) plan.engine = ENGINE_THREE_WAY;
+            if (pi - low < high - pi) {
+                hybridSort(arr, low, pi - 1, plan);
+                low = pi + 1;
+            } else {
+                hybridSort(arr, pi + 1, high, plan);
+                high = pi - 1;
+            }
+            continue;
+        }
+
+        int l, g;
+        if (plan.engine == ENGINE_DUAL_PIVOT) {
+            swap(arr[low], arr[low + rand() % (high - low + 1)]);
+            swap(arr[high], arr[low + 1 + rand() % (high - low)]);
+            partitionDualPivot(arr, low, high, l, g);
+        } else {
+            partitionThreeWay(arr, low, high, arr[low + rand() % (high - low + 1)], l, g);
+        }
+
+        // Parts arr[low..l-1], arr[l+1..g-1] and arr[g+1..high]. The
+        // middle one is all pivot copies (and needs no sorting) for the
+        // three-way engine, and for dual-pivot when the pivots are equal.
+        int lo[3] = {low, l + 1, g + 1};
+        int hi[3] = {l - 1, g - 1, high};
+        if (plan.engine == ENGINE_THREE_WAY || arr[l] == arr[g]) hi[1] = lo[1] - 1;
+
+        int big = 0;
+        for (int p = 1; p < 3; p++) {
+            if (hi[p] - lo[p] > hi[big] - lo[big]) big = p;
+        }
+        for (int p = 0; p < 3; p++) {
+            if (p != big) hybridSort(arr, lo[p], hi[p], plan);
+        }
+        low = lo[big];
+        high = hi[big];
+    }
+    insertionSort(arr, low, high);
+}
+
+// Looks at SAMPLE_SIZE evenly spaced elements: how many neighbours are in
+// ascending / descending order, and how many distinct values they hold
+InputClass classifyInput(const vector<int>& arr, int low, int high,
+                         double& ascending, double& descending) {
+    int n = high - low + 1;
+    int s = min(n, SAMPLE_SIZE);
+    vector<int> sample(s);
+    for (int i = 0; i < s; i++) sample[i] = arr[low + (long long)i * n / s];
+
+    int asc = 0, desc = 0;
+    for (int i = 1; i < s; i++) {
+        if (sample[i - 1] <= sample[i]) asc++;
+        if (sample[i - 1] >= sample[i]) desc++;
+    }
+    ascending = s > 1 ? (double)asc / (s - 1) : 1;
+    descending = s > 1 ? (double)desc / (s - 1) : 1;
+
+    sort(sample.begin(), sample.end());
+    double distinct = (double)(unique(sample.begin(), sample.end()) - sample.begin()) / s;
+
+    if (distinct < profile.fewUnique) return CLASS_FEW_UNIQUE;
+    if (ascending >= profile.nearlySorted || descending >= profile.nearlySorted) return CLASS_NEARLY_SORTED;
+    return CLASS_RANDOM;
+}
+
+void adaptiveSort(vector<int>& arr, int low, int high) {
+    if (high <= low) return;
+    double ascending, descending;
+    InputClass c = classifyInput(arr, low, high, ascending, descending);
+
+    // A fully ordered sample is worth one linear check
+    if (ascending == 1 && is_sorted(arr.begin() + low, arr.begin() + high + 1)) return;
+    if (descending == 1 && is_sorted(arr.begin() + low, arr.begin() + high + 1, greater<int>())) {
+        reverse(arr.begin() + low, arr.begin() + high + 1);
+        return;
+    }
+    hybridSort(arr, low, high, profile.plan[c][sizeBucket(high - low + 1)]);
+}
+
+// Profile file: "<class> <max_n> <engine> <cutoff>" per line, plus
+// "nearlysorted_threshold <x>" / "fewunique_threshold <x>"; '#' starts a
+// comment. Lines it does not recognise are skipped.
+bool loadProfile(const string& path, SortProfile& p) {
+    ifstream in(path);
+    if (!in) return false;
+    string line;
+    while (getline(in, line)) {
+        istringstream ss(line);
+        string key;
+        if (!(ss >> key) || key[0] == '#') continue;
+        if (key == "nearlysorted_threshold") { ss >> p.nearlySorted; continue; }
+        if (key == "fewunique_threshold") { ss >> p.fewUnique; continue; }
+
+        int c = find(CLASS_NAMES, CLASS_NAMES + NUM_CLASSES, key) - CLASS_NAMES;
+        int maxN, cutoff;
+        string engine;
+        if (c == NUM_CLASSES || !(ss >> maxN >> engine >> cutoff)) continue;
+        int e = find(ENGINE_NAMES, ENGINE_NAMES + NUM_ENGINES, engine) - ENGINE_NAMES;
+        if (e == NUM_ENGINES || cutoff < 1) continue;
+        p.plan[c][sizeBucket(maxN)] = {(SortEngine)e, cutoff};
+    }
+    return true;
+}
+
+bool saveProfile(const string& path, const SortProfile& p) {
+    ofstream out(path);
+    if (!out) return false;
+    out << "# quicksort profile: <class> <max_n> <engine> <cutoff>\n"
+        << "nearlysorted_threshold " << p.nearlySorted << "\n"
+        << "fewunique_threshold " << p.fewUnique << "\n";
+    for (int c = 0; c < NUM_CLASSES; c++)
+        for (int b = 0; b < NUM_BUCKETS; b++)
+            out << CLASS_NAMES[c] << " " << SIZE_BUCKETS[b] << " "
+                << ENGINE_NAMES[p.plan[c][b].engine] << " " << p.plan[c][b].cutoff << "\n";
+    return true;
+}
+
 // ==========================================
 // DATA GENERATORS & BENCHMARK
 // ==========================================
@@ -131,11 +461,143 @@ double measureTime(void (*sortFunc)(vector<int>&, int, int), vector<int>& arr) {
     return duration.count() / 1000.0; 
 }
 
-int main() {
+// Index of the median, the top-k prefix length, and the quantile indices
+// of arr[low..high], as used by the selection columns
+int topK(int low, int high) {
+    return max(1, (high - low + 1) * TOP_K_PERCENT / 100);
+}
+
+vector<int> quantileIndices(int low, int high) {
+    vector<int> ks;
+    for (int q = 1; q <= NUM_QUANTILES; q++)
+        ks.push_back(low + (long long)(high - low + 1) * q / (NUM_QUANTILES + 1));
+    return ks;
+}
+
+void selectMedian(vector<int>& arr, int low, int high) {
+    introSelect(arr, low, high, low + (high - low) / 2);
+}
+
+void selectTopK(vector<int>& arr, int low, int high) {
+    partialSort(arr, low, high, topK(low, high));
+}
+
+void selectQuantiles(vector<int>& arr, int low, int high) {
+    multiSelect(arr, low, high, quantileIndices(low, high));
+}
+
+// Times the three selection routines on copies of 'data' and checks each
+// against the fully sorted copy
+void measureSelection(const vector<int>& data, const vector<int>& sorted,
+                      double& tSel, double& tTopK, double& tMulti) {
+    int high = data.size() - 1;
+    vector<int> a = data, b = data, c = data;
+    tSel = measureTime(selectMedian, a);
+    tTopK = measureTime(selectTopK, b);
+    tMulti = measureTime(selectQuantiles, c);
+
+    bool ok = a[high / 2] == sorted[high / 2];
+    ok = ok && equal(b.begin(), b.begin() + topK(0, high), sorted.begin());
+    for (int k : quantileIndices(0, high)) ok = ok && c[k] == sorted[k];
+    if (!ok) cerr << "Selection mismatch at n=" << data.size() << endl;
+}
+
+// ==========================================
+// CALIBRATION (--calibrate)
+// ==========================================
+const int CALIBRATION_ELEMENTS = 1000000; // sorted per candidate plan and size
+const vector<int> CALIBRATION_CUTOFFS = {8, 16, 24, 32, 48, 64, 96, 128};
+
+// Representative input of each class: uniform values, sorted with 1% of
+// positions swapped at random, and 16 distinct values
+vector<int> generateClassArray(InputClass c, int n) {
+    if (c == CLASS_RANDOM) return generateRandomArray(n);
+    if (c == CLASS_FEW_UNIQUE) {
+        vector<int> arr(n);
+        for (int i = 0; i < n; i++) arr[i] = rand() % 16;
+        return arr;
+    }
+    vector<int> arr = generateSortedArray(n);
+    for (int i = 0; i < n / 100; i++) swap(arr[rand() % n], arr[rand() % n]);
+    return arr;
+}
+
+// Times every engine and cutoff on each class and size bucket, keeps the
+// fastest, and writes the whole sweep to 'out'
+SortProfile calibrate(const string& out) {
+    SortProfile p;
+    ResultSink sweep(out, {"Class", "MaxN", "Engine", "Cutoff", "Time_Per_Sort"});
+    for (int c = 0; c < NUM_CLASSES; c++) {
+        for (int b = 0; b < NUM_BUCKETS; b++) {
+            int n = SIZE_BUCKETS[b];
+            int reps = max(3, CALIBRATION_ELEMENTS / n);
+            vector<int> data = generateClassArray((InputClass)c, n);
+            double best = 1e300;
+
+            for (int e = 0; e < NUM_ENGINES; e++) {
+                for (int cutoff : CALIBRATION_CUTOFFS) {
+                    SortPlan plan = {(SortEngine)e, cutoff};
+                    double total = 0;
+                    for (int r = 0; r < reps; r++) {
+                        vector<int> arr = data;
+                        auto start = high_resolution_clock::now();
+                        hybridSort(arr, 0, n - 1, plan);
+                        auto stop = high_resolution_clock::now();
+                        total += duration<double, milli>(stop - start).count();
+                    }
+                    double t = total / reps;
+                    sweep.row() << CLASS_NAMES[c] << n << ENGINE_NAMES[e] << cutoff << t;
+                    if (t < best) {
+                        best = t;
+                        p.plan[c][b] = plan;
+                    }
+                }
+            }
+        }
+    }
+    return p;
+}
+
+int main(int argc, char** argv) {
     srand(time(0));
 
-    // Updated Header with Dual Pivot
-    cout << "Size,InputType,Run_ID,Time_Standard,Time_Randomized,Time_DualPivot" << endl;
+    // ./quicksort [--profile file] [--out file]  or  ./quicksort --calibrate [file]
+    // Results go to stdout unless --out names a .csv or .col file
+    string profilePath = "sort_profile.txt";
+    string outPath = "-";
+    bool calibrateOnly = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--calibrate") {
+            calibrateOnly = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') profilePath = argv[++i];
+        } else if (arg == "--profile" && i + 1 < argc) {
+            profilePath = argv[++i];
+        } else if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            cerr << "Usage: ./quicksort [--profile file] [--out results.{csv,col}]\n"
+                 << "       ./quicksort --calibrate [file] [--out sweep.{csv,col}]" << endl;
+            return 1;
+        }
+    }
+
+    if (calibrateOnly) {
+        profile = calibrate(outPath);
+        if (!saveProfile(profilePath, profile)) {
+            cerr << "Cannot write " << profilePath << endl;
+            return 1;
+        }
+        cerr << "Saved profile: " << profilePath << endl;
+        return 0;
+    }
+    if (loadProfile(profilePath, profile)) cerr << "Loaded profile: " << profilePath << endl;
+
+    // Timings: the three quicksorts, the three selection routines, then adaptiveSort
+    // Rows are queued and written by a background thread, off the timed path
+    ResultSink results(outPath, {"Size", "InputType", "Run_ID",
+                                 "Time_Standard", "Time_Randomized", "Time_DualPivot",
+                                 "Time_Select", "Time_TopK", "Time_MultiSelect", "Time_Adaptive"});
 
     for (int n : SIZES) {
         
@@ -143,16 +605,24 @@ int main() {
         for (int k = 1; k <= NUM_RUNS; k++) {
             vector<int> originalData = generateRandomArray(n);
             
-            // Three identical copies
+            // Four identical copies: the three quicksorts and adaptiveSort
             vector<int> d1 = originalData;
             vector<int> d2 = originalData;
             vector<int> d3 = originalData;
+            vector<int> d4 = originalData;
 
             double tStd = measureTime(quickSortStandard, d1);
             double tRnd = measureTime(quickSortRandomized, d2);
             double tDual = measureTime(quickSortDualPivot, d3);
+            double tAdapt = measureTime(adaptiveSort, d4);
+            if (d4 != d2) cerr << "Adaptive sort mismatch at n=" << n << endl;
+
+            // Median, top-k and deciles only (d2 is the sorted reference)
+            double tSel, tTopK, tMulti;
+            measureSelection(originalData, d2, tSel, tTopK, tMulti);
 
-            cout << n << ",Random," << k << "," << tStd << "," << tRnd << "," << tDual << endl;
+            results.row() << n << "Random" << k << tStd << tRnd << tDual
+                          << tSel << tTopK << tMulti << tAdapt;
         }
 
         // --- 2. Sorted Input ---
@@ -161,12 +631,20 @@ int main() {
             vector<int> d1 = generateSortedArray(n);
             vector<int> d2 = d1;
             vector<int> d3 = d1;
+            vector<int> d4 = d1;
+            vector<int> original = d1;
 
             double tStd = measureTime(quickSortStandard, d1);
             double tRnd = measureTime(quickSortRandomized, d2);
             double tDual = measureTime(quickSortDualPivot, d3);
+            double tAdapt = measureTime(adaptiveSort, d4);
+            if (d4 != d2) cerr << "Adaptive sort mismatch at n=" << n << endl;
+
+            double tSel, tTopK, tMulti;
+            measureSelection(original, d2, tSel, tTopK, tMulti);
 
-            cout << n << ",Sorted," << k << "," << tStd << "," << tRnd << "," << tDual << endl;
+            results.row() << n << "Sorted" << k << tStd << tRnd << tDual
+                          << tSel << tTopK << tMulti << tAdapt;
         }
     }
 